@@ -0,0 +1,69 @@
+/*
+ * Modulino Buttons - Gestures
+ *
+ * This example demonstrates the gesture engine built into ModulinoButtons.
+ * Every update() reads the three buttons once and recognizes debounced
+ * clicks, double-clicks, multi-clicks, long presses and auto-repeat,
+ * queuing them with their timestamps. No extra library is needed.
+ *
+ * - Click, double-click or triple-click any button
+ * - Hold a button to get a long press, keep holding to auto-repeat
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoButtons buttons;
+
+const char names[] = { 'A', 'B', 'C' };
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  buttons.begin();
+
+  buttons.setDebounce(35);
+  buttons.setClickTimeout(300);
+  buttons.setLongPress(800);
+  buttons.setRepeat(200);
+}
+
+void loop() {
+  buttons.update();
+
+  ModulinoButtons::Event event;
+  while (buttons.readEvent(event)) {
+    switch (event.type) {
+      case ModulinoButtons::EVENT_CLICK:
+        Serial.print("click");
+        break;
+      case ModulinoButtons::EVENT_DOUBLE_CLICK:
+        Serial.print("double click");
+        break;
+      case ModulinoButtons::EVENT_MULTI_CLICK:
+        Serial.print(event.count);
+        Serial.print(" clicks");
+        break;
+      case ModulinoButtons::EVENT_LONG_PRESS:
+        Serial.print("long press");
+        break;
+      case ModulinoButtons::EVENT_REPEAT:
+        Serial.print("repeat ");
+        Serial.print(event.count);
+        break;
+      default:
+        // raw press and release events are not printed
+        continue;
+    }
+    Serial.print(" on ");
+    Serial.print(names[event.button]);
+    Serial.print(" at ");
+    Serial.print(event.timestamp);
+    Serial.println(" ms");
+  }
+
+  delay(5);
+}
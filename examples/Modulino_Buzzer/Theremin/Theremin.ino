@@ -57,6 +57,7 @@ void loop() {
   // Get distance measurement in millimeters and use it as pitch offset
   pitch = distance.get();
   // Get current encoder position to select which note to play
+  encoder.update();
   noteIndex = encoder.get();
 
   // Use modulo to keep noteIndex within valid range (0-11)
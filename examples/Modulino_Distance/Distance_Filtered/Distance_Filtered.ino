@@ -0,0 +1,44 @@
+/*
+ * Modulino Distance - Filtered
+ *
+ * This example smooths distance readings with the built-in filter:
+ * weak or uncertain results are rejected using the signal rate and sigma
+ * reported by the sensor, then a median and a Kalman filter are applied.
+ * Raw, median and filtered values are printed side by side, open the
+ * Serial Plotter to compare them.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoDistance distance;
+
+// keep the last 16 samples, median over 5
+ModulinoDistanceFilter<16, 5> filter;
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  distance.begin();
+
+  // reject results with a weak return or a large uncertainty
+  filter.setSignalThreshold(1000);
+  filter.setSigmaThreshold(15);
+  // expect changes of roughly 50 mm per second
+  filter.setProcessNoise(50);
+}
+
+void loop() {
+  if (filter.update(distance)) {
+    const auto& sample = filter.sample(0);
+    Serial.print("raw:");
+    Serial.print(sample.raw);
+    Serial.print(",median:");
+    Serial.print(sample.median);
+    Serial.print(",filtered:");
+    Serial.println(sample.filtered);
+  }
+}
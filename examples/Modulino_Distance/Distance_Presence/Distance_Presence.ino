@@ -0,0 +1,33 @@
+/*
+ * Modulino Distance - Presence
+ *
+ * This example uses the sensor as a presence trigger. The distance window
+ * is evaluated by the sensor itself: while nothing is closer than 300 mm
+ * the sketch only reads a status flag once per measurement, and a full
+ * result is fetched only when something enters the window.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoDistance distance;
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  distance.begin();
+
+  // Report only results closer than 300 mm
+  distance.setDetection(ModulinoDistance::DETECT_BELOW, 300);
+}
+
+void loop() {
+  if (distance.detected()) {
+    Serial.print("Something at ");
+    Serial.print(distance.get());
+    Serial.println(" mm");
+  }
+}
@@ -0,0 +1,50 @@
+/*
+ * Modulino Distance - Ranging Modes
+ *
+ * This example demonstrates the ranging timing presets. Send a digit over
+ * the Serial Monitor to switch mode:
+ * - '1' short latency: 10 ms budget, back to back
+ * - '2' balanced: 20 ms budget, back to back (default)
+ * - '3' long range: 200 ms budget, best range and accuracy
+ * - '4' low power: 20 ms budget every 500 ms
+ *
+ * The library knows when the next result is due and does not query the
+ * sensor before that, so calling available() often costs no bus traffic.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoDistance distance;
+
+unsigned long lastPrint = 0;
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  distance.begin();
+}
+
+void loop() {
+  if (Serial.available()) {
+    char c = Serial.read();
+    if (c >= '1' && c <= '4') {
+      distance.setRangingMode((ModulinoDistance::RangingMode)(c - '1'));
+      Serial.print("Timing budget: ");
+      Serial.print(distance.getTimingBudget());
+      Serial.print(" ms, inter measurement: ");
+      Serial.print(distance.getInterMeasurement());
+      Serial.println(" ms");
+    }
+  }
+
+  // Polled at 50 Hz
+  if (distance.available() && millis() - lastPrint >= 100) {
+    Serial.println(distance.get());
+    lastPrint = millis();
+  }
+  delay(20);
+}
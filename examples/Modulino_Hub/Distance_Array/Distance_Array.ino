@@ -0,0 +1,58 @@
+/*
+ * Modulino Hub - Distance Array
+ *
+ * This example ranges with four Modulino Distance sensors, one per Hub
+ * port. All sensors range at the same time with their results spread over
+ * the measurement period, and each result is collected as soon as it is
+ * due, so the array delivers about four times the rate of a single sensor.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoHub hub;
+
+ModulinoDistance distance0(hub.port(0));
+ModulinoDistance distance1(hub.port(1));
+ModulinoDistance distance2(hub.port(2));
+ModulinoDistance distance3(hub.port(3));
+
+ModulinoDistanceArray<4> sensors;
+
+unsigned long results = 0;
+unsigned long lastReport = 0;
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+
+  sensors.add(distance0);
+  sensors.add(distance1);
+  sensors.add(distance2);
+  sensors.add(distance3);
+
+  // 20 ms timing budget, back to back ranging
+  int found = sensors.begin(20);
+  Serial.print("Sensors ranging: ");
+  Serial.println(found);
+}
+
+void loop() {
+  int index = sensors.poll();
+  if (index >= 0) {
+    results++;
+    Serial.print(index);
+    Serial.print(": ");
+    Serial.println(sensors.get(index));
+  }
+
+  if (millis() - lastReport >= 1000) {
+    Serial.print("Results per second: ");
+    Serial.println(results);
+    results = 0;
+    lastReport = millis();
+  }
+}
@@ -5,8 +5,8 @@
  * from the Modulino Joystick module.
  * 
  * The joystick has:
- * - X-axis: horizontal movement (-100 to +100, center is 0)
- * - Y-axis: vertical movement (-100 to +100, center is 0)
+ * - X-axis: horizontal movement (-127 to +127, center is 0)
+ * - Y-axis: vertical movement (-127 to +127, center is 0)
  * - Button: can be pressed down (click the joystick)
  * 
  * Coordinate system:
@@ -42,8 +42,8 @@ void loop() {
   }
 
   // Print the X and Y coordinates
-  // X: -100 (left) to +100 (right)
-  // Y: -100 (down) to +100 (up)
+  // X: -127 (left) to +127 (right)
+  // Y: -127 (down) to +127 (up)
   Serial.print("x,y: ");
   Serial.print(joystick.getX());
   Serial.print(", ");
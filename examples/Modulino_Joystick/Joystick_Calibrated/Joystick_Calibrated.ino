@@ -0,0 +1,57 @@
+/*
+ * Modulino Joystick - Calibrated
+ *
+ * This example demonstrates the joystick processing pipeline: center and
+ * range calibration, a round dead zone rescaled so the output starts at 0
+ * at its edge, a fixed-point expo curve for fine control near the center,
+ * and a change threshold so update() ignores jitter of a few counts.
+ *
+ * Leave the stick released at startup, then move it around its full
+ * travel for three seconds while the range is calibrated.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoJoystick joystick;
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  joystick.begin();
+
+  joystick.calibrateCenter();
+
+  bool calibrated = false;
+  while (!calibrated) {
+    Serial.println("Move the stick all around...");
+    joystick.beginRangeCalibration();
+    unsigned long start = millis();
+    while (millis() - start < 3000) {
+      joystick.update();
+      delay(10);
+    }
+    // false when a side was not reached; it keeps its previous range
+    calibrated = joystick.endRangeCalibration();
+  }
+  Serial.println("Done");
+
+  joystick.setDeadZone(12, ModulinoJoystick::DEAD_ZONE_SCALED);
+  joystick.setExpo(96);
+  joystick.setChangeThreshold(3);
+}
+
+void loop() {
+  // Only print when the stick really moved
+  if (joystick.update()) {
+    Serial.print("x,y: ");
+    Serial.print(joystick.getX());
+    Serial.print(", ");
+    Serial.print(joystick.getY());
+    Serial.println(joystick.isPressed() ? " pressed" : "");
+  }
+  delay(10);
+}
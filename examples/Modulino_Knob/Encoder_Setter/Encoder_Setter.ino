@@ -42,6 +42,9 @@ void setup() {
 }
 
 void loop() {
+  // Read the encoder once, get() returns this snapshot
+  encoder.update();
+
   // Get current encoder position value
   int value = encoder.get();
   
@@ -51,7 +54,7 @@ void loop() {
     encoder.set(0);  // Reset to 0 if outside range
   }
 
-  // Get updated encoder value after possible reset
+  // Get updated encoder value after possible reset (set() updates the snapshot)
   value = encoder.get();
 
   // Print current value to Serial Monitor
@@ -41,15 +41,18 @@ void setup() {
 }
 
 void loop(){
+  // Read position and button in a single transaction
+  // The getters below return this snapshot without touching the bus
+  knob.update();
+
   // Get the current position value of the knob
   // This value increments when turned clockwise, decrements when turned counter-clockwise
   int position = knob.get();
   
   // Check if the knob has been pressed (clicked)
-  // Returns true on the first call after a press, then false until next press
   bool click = knob.isPressed();
   
-  // Get the rotation direction since last check
+  // Get the rotation direction seen by the last update
   // Returns: 1 for clockwise, -1 for counter-clockwise, 0 for no rotation
   int8_t direction = knob.getDirection();
 
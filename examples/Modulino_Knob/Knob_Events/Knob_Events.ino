@@ -0,0 +1,57 @@
+/*
+ * Modulino Knob - Events
+ *
+ * This example demonstrates the knob input engine: a single read per
+ * update(), rotation accumulated without losing detents, acceleration so a
+ * fast spin covers a large range, and a queue of timestamped rotate, press,
+ * release and long-press events.
+ *
+ * Turn slowly to change the value one by one, spin fast to jump.
+ * Press to print the value, hold to reset it to 0.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoKnob knob;
+
+int value = 500;
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  knob.begin();
+
+  // Up to 10 counts per detent when spinning at 80 detents per second or more
+  knob.setAcceleration(10, 15, 80);
+  knob.setLongPress(800);
+}
+
+void loop() {
+  knob.update();
+
+  ModulinoKnob::Event event;
+  while (knob.readEvent(event)) {
+    switch (event.type) {
+      case ModulinoKnob::EVENT_ROTATE:
+        value = constrain(value + event.delta, 0, 1000);
+        break;
+      case ModulinoKnob::EVENT_PRESS:
+        Serial.print(event.timestamp);
+        Serial.print(" ms: value ");
+        Serial.println(value);
+        break;
+      case ModulinoKnob::EVENT_LONG_PRESS:
+        value = 0;
+        Serial.println("Reset");
+        break;
+      default:
+        break;
+    }
+  }
+
+  delay(5);
+}
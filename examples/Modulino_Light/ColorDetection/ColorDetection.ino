@@ -119,6 +119,11 @@ void readColors() {
 
 // Handles knob button presses to set special color values and combinations
 void knobPressed() {
+  // Take one snapshot of each knob
+  knob_red.update();
+  knob_green.update();
+  knob_blue.update();
+
   // Read current knob positions (0-255)
   red = knob_red.get();
   green = knob_green.get();
@@ -216,9 +221,10 @@ void updatesColors() {
     Serial.print("\tBlue:\t");
     Serial.print(buffer);
 
-    // Get detected color from the light sensor
-    ModulinoColor color = light.getColor();
-    String colorName = light.getColorApproximate();
+    // Get detected color from the light sensor, formatted into a fixed
+    // buffer so the long running sketch never allocates on the heap
+    char colorName[ModulinoLight::COLOR_NAME_LENGTH];
+    light.getColorApproximate(colorName, sizeof(colorName));
     Serial.print("\tColor near to:\t");
     Serial.print(colorName);
     Serial.println();
@@ -0,0 +1,150 @@
+/*
+ * Modulino Light - Color Benchmark
+ *
+ * This example compares the integer only color classifier of ModulinoLight
+ * with a float HSL implementation of the same rules. Both run over a grid
+ * of RGB values, the sketch prints the time per classification and how many
+ * colors were classified the same way. The few differences come from
+ * float rounding on colors lying exactly on a threshold.
+ *
+ * Afterwards the sensor reading is classified into a fixed buffer, which
+ * never touches the heap.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoLight light;
+
+const int STEP = 17;  // 16 values per channel, 4096 colors
+
+// Float reference: HSL in percent and degrees, same thresholds as the library
+ModulinoLight::ColorClass classifyFloat(int red, int green, int blue) {
+  ModulinoLight::ColorClass color = {ModulinoLight::COLOR_WHITE, ModulinoLight::LIGHTNESS_NORMAL, ModulinoLight::SATURATION_NORMAL};
+  float r = red / 255.0, g = green / 255.0, b = blue / 255.0;
+  float hi = max(r, max(g, b));
+  float lo = min(r, min(g, b));
+  float delta = hi - lo;
+  float l = (hi + lo) / 2;
+  float s = 0, h = 0;
+  if (delta > 0) {
+    s = l > 0.5 ? delta / (2 - hi - lo) : delta / (hi + lo);
+    if (hi == r) {
+      h = 60 * fmod((g - b) / delta, 6);
+    } else if (hi == g) {
+      h = 60 * ((b - r) / delta + 2);
+    } else {
+      h = 60 * ((r - g) / delta + 4);
+    }
+  }
+  l *= 100;
+  s *= 100;
+  if (l > 90.0) {
+    return color;
+  }
+  if (l <= 0.20) {
+    color.base = ModulinoLight::COLOR_BLACK;
+    return color;
+  }
+  if (s < 10.0) {
+    color.base = l < 50.0 ? ModulinoLight::COLOR_DARK_GRAY : ModulinoLight::COLOR_LIGHT_GRAY;
+    return color;
+  }
+  if (h < 0) {
+    h += 360;
+  }
+  color.base = (ModulinoLight::ColorBase)(((int)((h + 15) / 30)) % 12);
+  if (l < 20.0) {
+    color.lightness = ModulinoLight::LIGHTNESS_VERY_DARK;
+  } else if (l < 40.0) {
+    color.lightness = ModulinoLight::LIGHTNESS_DARK;
+  } else if (l > 80.0) {
+    color.lightness = ModulinoLight::LIGHTNESS_VERY_LIGHT;
+  } else if (l > 60.0) {
+    color.lightness = ModulinoLight::LIGHTNESS_LIGHT;
+  }
+  if (s < 20.0) {
+    color.saturation = ModulinoLight::SATURATION_VERY_PALE;
+  } else if (s < 40.0) {
+    color.saturation = ModulinoLight::SATURATION_PALE;
+  } else if (s > 80.0) {
+    color.saturation = ModulinoLight::SATURATION_VERY_VIVID;
+  } else if (s > 60.0) {
+    color.saturation = ModulinoLight::SATURATION_VIVID;
+  }
+  return color;
+}
+
+bool sameClass(const ModulinoLight::ColorClass& a, const ModulinoLight::ColorClass& b) {
+  return a.base == b.base && a.lightness == b.lightness && a.saturation == b.saturation;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Modulino.begin();
+  light.begin();
+
+  // keep the results in a volatile sink so the loops are not optimized away
+  volatile uint8_t sink = 0;
+  unsigned long count = 0;
+
+  unsigned long start = micros();
+  for (int r = 0; r < 256; r += STEP) {
+    for (int g = 0; g < 256; g += STEP) {
+      for (int b = 0; b < 256; b += STEP) {
+        sink = ModulinoLight::classifyColor(r, g, b).base;
+        count++;
+      }
+    }
+  }
+  unsigned long integerTime = micros() - start;
+
+  start = micros();
+  for (int r = 0; r < 256; r += STEP) {
+    for (int g = 0; g < 256; g += STEP) {
+      for (int b = 0; b < 256; b += STEP) {
+        sink = classifyFloat(r, g, b).base;
+      }
+    }
+  }
+  unsigned long floatTime = micros() - start;
+  (void)sink;
+
+  unsigned long same = 0;
+  for (int r = 0; r < 256; r += STEP) {
+    for (int g = 0; g < 256; g += STEP) {
+      for (int b = 0; b < 256; b += STEP) {
+        if (sameClass(ModulinoLight::classifyColor(r, g, b), classifyFloat(r, g, b))) {
+          same++;
+        }
+      }
+    }
+  }
+
+  Serial.print("Integer: ");
+  Serial.print((float)integerTime / count, 2);
+  Serial.println(" us per color");
+  Serial.print("Float:   ");
+  Serial.print((float)floatTime / count, 2);
+  Serial.println(" us per color");
+  Serial.print("Same result for ");
+  Serial.print(same);
+  Serial.print(" of ");
+  Serial.print(count);
+  Serial.println(" colors");
+}
+
+void loop() {
+  char name[ModulinoLight::COLOR_NAME_LENGTH];
+
+  light.update();
+  light.getColorApproximate(name, sizeof(name));
+  Serial.print("Color near to: ");
+  Serial.println(name);
+
+  delay(500);
+}
@@ -0,0 +1,42 @@
+/*
+ * Modulino Light - Lux Auto Range
+ *
+ * This example reads only the ambient light level and lets the library
+ * adapt gain and integration time to it. Each update is a short register
+ * burst instead of a full color read. Cover the sensor or shine a light on
+ * it to see the range follow.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoLight light;
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  light.begin();
+
+  // Only the ambient light channel is read
+  light.setChannels(ModulinoLight::CHANNEL_LUX);
+
+  // Start fast, allow longer integration in the dark
+  light.setIntegrationTime(50);
+  light.setAutoRange(true);
+}
+
+void loop() {
+  // false while no new conversion is available
+  if (light.update()) {
+    Serial.print("Lux: ");
+    Serial.print(light.getLux());
+    Serial.print("\tGain: ");
+    Serial.print(light.getGain());
+    Serial.print("x\tIntegration: ");
+    Serial.print(light.getIntegrationTime());
+    Serial.println(" ms");
+  }
+}
@@ -0,0 +1,83 @@
+/*
+ * Modulino Light - Palette
+ *
+ * This example matches the color under the sensor against a palette taught
+ * at runtime. Open the Serial Monitor and send:
+ * - 'd' with the sensor covered to record the dark reference
+ * - 'w' over a white target to record the white reference
+ * - 'a' over a sample to add it to the palette
+ * - 'b' to build the lookup table and start matching
+ * - 'c' to clear the palette
+ *
+ * After 'b' every reading is classified with a single table lookup.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoLight light;
+
+// up to 32 colors, 16 levels per channel (4 kB table)
+ModulinoLightPalette<32, 4> palette;
+
+bool matching = false;
+uint8_t lastMatch = palette.NO_MATCH;
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  light.begin();
+
+  // ignore matches further than this CIELAB distance
+  palette.setMaxDistance(25);
+
+  Serial.println("Commands: d = dark, w = white, a = add color, b = build, c = clear");
+}
+
+void loop() {
+  if (Serial.available()) {
+    switch (Serial.read()) {
+      case 'd':
+        Serial.println(palette.calibrateDark(light) ? "Dark reference recorded" : "Dark calibration failed");
+        break;
+      case 'w':
+        Serial.println(palette.calibrateWhite(light) ? "White reference recorded" : "White calibration failed");
+        break;
+      case 'a': {
+        int index = palette.addColor(light);
+        if (index < 0) {
+          Serial.println("Palette full");
+        } else {
+          Serial.print("Added color ");
+          Serial.println(index);
+        }
+        break;
+      }
+      case 'b':
+        matching = palette.build();
+        Serial.println(matching ? "Matching started" : "Add some colors first");
+        break;
+      case 'c':
+        palette.clear();
+        matching = false;
+        Serial.println("Palette cleared");
+        break;
+    }
+  }
+
+  if (matching && light.update()) {
+    uint8_t match = palette.match(light);
+    if (match != lastMatch) {
+      lastMatch = match;
+      if (match == palette.NO_MATCH) {
+        Serial.println("No match");
+      } else {
+        Serial.print("Color ");
+        Serial.println(match);
+      }
+    }
+  }
+}
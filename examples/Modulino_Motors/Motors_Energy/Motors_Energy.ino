@@ -0,0 +1,63 @@
+/*
+ * Modulino Motors - Energy
+ *
+ * This example demonstrates charge and energy accounting.
+ * Every update() integrates the sensed current of both channels; totals are
+ * kept for the whole run and for each move or speed command, so the energy
+ * spent per move can be compared over time.
+ *
+ * This example code is in the public domain.
+ * Copyright (C) Arduino s.r.l. and/or its affiliated companies
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoMotors motors;
+
+void printReport(const char* label, const ModulinoMotors::EnergyReport& report) {
+  Serial.print(label);
+  Serial.print(" | t=");
+  Serial.print(report.durationMs);
+  Serial.print(" ms | Q_A=");
+  Serial.print(report.chargeMahA, 4);
+  Serial.print(" mAh | Q_B=");
+  Serial.print(report.chargeMahB, 4);
+  Serial.print(" mAh | E=");
+  Serial.print(report.energyJA + report.energyJB, 3);
+  Serial.println(" J");
+}
+
+/**
+ * Run both motors at the given speed for some time, polling telemetry often.
+ */
+void run(uint8_t speed, unsigned long durationMs) {
+  motors.setSpeedA(speed);
+  motors.setSpeedB(speed);
+  unsigned long start = millis();
+  while (millis() - start < durationMs) {
+    motors.update();
+    delay(10);
+  }
+}
+
+void setup() {
+  Serial.begin(9600);
+  Modulino.begin();
+  motors.begin();
+
+  motors.setStepperModeEnabled(false);  // DC mode
+  motors.setSupplyVoltage(12.0f);       // set to your motor supply voltage
+}
+
+void loop() {
+  run(40, 2000);
+  run(80, 2000);  // starting this segment closes the 40% one
+  printReport("Segment at 40%", motors.energyLastSegment());
+
+  motors.stop();
+  motors.update();
+  printReport("Segment at 80%", motors.energyLastSegment());
+  printReport("Total", motors.energyTotal());
+  delay(2000);
+}
@@ -0,0 +1,48 @@
+/*
+ * Modulino Motors - Frequency Auto-Tune
+ *
+ * This example demonstrates automatic DC PWM frequency tuning.
+ * The library sweeps 200..60000 Hz, first coarsely and then finely around
+ * the best point, measures mean and ripple current through telemetry, and
+ * applies the frequency with the lowest current draw at the given speed.
+ *
+ * This example code is in the public domain.
+ * Copyright (C) Arduino s.r.l. and/or its affiliated companies
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoMotors motors;
+
+constexpr uint8_t TUNE_SPEED = 50;
+ModulinoMotors::FrequencySample results[20];
+
+void setup() {
+  Serial.begin(9600);
+  Modulino.begin();
+  motors.begin();
+
+  motors.setStepperModeEnabled(false);  // DC mode
+  motors.setDecay(ModulinoMotors::DecayMode::FAST);
+
+  Serial.println("Tuning, this takes a few seconds...");
+  uint16_t best = motors.autoTuneFrequency(TUNE_SPEED, results, 20);
+
+  for (size_t i = 0; i < 20 && results[i].frequencyHz != 0; i++) {
+    Serial.print(results[i].frequencyHz);
+    Serial.print(" Hz | mean=");
+    Serial.print(results[i].meanMa, 1);
+    Serial.print(" mA | ripple=");
+    Serial.print(results[i].rippleMa, 1);
+    Serial.println(" mA");
+  }
+  Serial.print("Selected frequency: ");
+  Serial.print(best);
+  Serial.println(" Hz");
+
+  motors.stop();
+}
+
+void loop() {
+}
@@ -0,0 +1,59 @@
+/*
+ * Modulino Motors - Soft Start
+ *
+ * This example demonstrates non-blocking DC speed ramping.
+ * With an acceleration set, setSpeedA()/setSpeedB() only change the target
+ * speed and tick() slews both channels towards it, avoiding the current
+ * spikes caused by jumping straight to full speed.
+ *
+ * This example code is in the public domain.
+ * Copyright (C) Arduino s.r.l. and/or its affiliated companies
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoMotors motors;
+
+unsigned long lastChange = 0;
+unsigned long lastPrint = 0;
+bool fast = false;
+
+void setup() {
+  Serial.begin(9600);
+  Modulino.begin();
+  motors.begin();
+
+  motors.setStepperModeEnabled(false);  // DC mode
+  motors.setDecay(ModulinoMotors::DecayMode::SLOW);
+
+  // Full scale is reached in one second: 0 -> 100% in 1 s.
+  motors.setAcceleration(100);
+}
+
+void loop() {
+  // Keep the ramp running, this never blocks.
+  motors.tick();
+
+  if (millis() - lastChange > 3000) {
+    lastChange = millis();
+    fast = !fast;
+    Serial.println(fast ? "Ramp up to 80%" : "Ramp down to 10%");
+    motors.setSpeedA(fast ? 80 : 10);
+    motors.setSpeedB(fast ? 80 : 10);
+  }
+
+  if (millis() - lastPrint > 100) {
+    lastPrint = millis();
+    if (motors.update()) {
+      int16_t rawA, rawB;
+      motors.dcSpeedRaw(rawA, rawB);
+      Serial.print("speed A=");
+      Serial.print(rawA);
+      Serial.print(" | I_A=");
+      Serial.print(motors.sensedCurrentA(), 1);
+      Serial.print(" mA | ramping=");
+      Serial.println(motors.ramping() ? "true" : "false");
+    }
+  }
+}
@@ -0,0 +1,72 @@
+/*
+ * Modulino Motors - Stepper Homing
+ *
+ * This example demonstrates absolute stepper positioning.
+ * The stepper is homed against a limit switch wired between LIMIT_PIN and GND,
+ * then moved between absolute positions with moveTo(). A move interrupted
+ * by stop() keeps an estimate of how far it got, so position() stays valid.
+ *
+ * This example code is in the public domain.
+ * Copyright (C) Arduino s.r.l. and/or its affiliated companies
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+// Uses default address and no hub port, with 200 full-steps/rev.
+ModulinoMotors motors(200);
+
+constexpr int LIMIT_PIN = 2;
+constexpr uint16_t HOMING_PERIOD = 50;  // 5 ms per step while homing
+constexpr uint16_t MOVE_PERIOD = 20;    // 2 ms per step for normal moves
+
+void waitUntilIdle() {
+  while (motors.moving()) {
+    delay(10);
+  }
+}
+
+void printPosition(const char* label) {
+  Serial.print(label);
+  Serial.print(" | position=");
+  Serial.println(motors.position());
+}
+
+void setup() {
+  Serial.begin(9600);
+  Modulino.begin();
+
+  if (!motors.begin()) {
+    Serial.println("Motors module not found!");
+    while (1);
+  }
+  pinMode(LIMIT_PIN, INPUT_PULLUP);
+
+  motors.setStepperModeEnabled(true);
+  motors.setHalfStepEnabled(false);
+  motors.setDecay(ModulinoMotors::DecayMode::FAST);
+
+  // Search at most 5 revolutions in the negative direction, switch closes to GND.
+  if (!motors.home(LIMIT_PIN, LOW, -1000, HOMING_PERIOD)) {
+    Serial.println("Limit switch not found!");
+    while (1);
+  }
+  printPosition("Homed");
+}
+
+void loop() {
+  motors.moveTo(400, MOVE_PERIOD);
+  waitUntilIdle();
+  printPosition("At 400");
+
+  motors.moveTo(100, MOVE_PERIOD);
+  waitUntilIdle();
+  printPosition("At 100");
+
+  // Interrupt a move halfway, the position is estimated from the elapsed time.
+  motors.moveTo(600, MOVE_PERIOD);
+  delay(500);
+  motors.hold();
+  printPosition("Interrupted");
+  delay(1000);
+}
@@ -0,0 +1,84 @@
+/*
+ * Modulino Motors - XY Plotter
+ *
+ * This example demonstrates coordinated two-axis stepper moves using two
+ * Modulino Motors boards grouped in a ModulinoMotorsGroup.
+ * Both axes start together and finish together, so diagonal moves come out
+ * as straight lines. A circle is drawn by streaming short line segments.
+ *
+ * The second board must be moved to a different I2C address first,
+ * for example with the AddressChanger utility sketch.
+ *
+ * This example code is in the public domain.
+ * Copyright (C) Arduino s.r.l. and/or its affiliated companies
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoMotors motorX;        // default address
+// the cast selects the address constructor; a plain int would be taken as steps per revolution
+ModulinoMotors motorY((uint8_t)0x25);  // second board, address changed with AddressChanger
+ModulinoMotorsGroup plotter;
+
+constexpr int32_t SIZE = 400;         // square side in steps
+constexpr int CIRCLE_SEGMENTS = 36;
+
+void setupAxis(ModulinoMotors& motors) {
+  motors.setStepperModeEnabled(true);
+  motors.setHalfStepEnabled(false);
+  motors.setDecay(ModulinoMotors::DecayMode::FAST);
+}
+
+/**
+ * Queue a move to (x, y), servicing the group while the queue is full.
+ */
+void lineTo(int32_t x, int32_t y) {
+  const int32_t target[2] = { x, y };
+  while (!plotter.moveTo(target)) {
+    plotter.poll();
+  }
+}
+
+void waitUntilDone() {
+  while (plotter.poll()) {
+    // other work can be done here while the plotter moves
+  }
+}
+
+void setup() {
+  Serial.begin(9600);
+  Modulino.begin();
+
+  if (!motorX.begin() || !motorY.begin()) {
+    Serial.println("Motors modules not found!");
+    while (1);
+  }
+  setupAxis(motorX);
+  setupAxis(motorY);
+
+  plotter.addAxis(motorX);
+  plotter.addAxis(motorY);
+  plotter.setMinPeriod(20);     // 2 ms per step on the dominant axis
+  plotter.setSegmentSteps(16);
+}
+
+void loop() {
+  Serial.println("Square with diagonals");
+  lineTo(SIZE, 0);
+  lineTo(SIZE, SIZE);
+  lineTo(0, 0);
+  lineTo(0, SIZE);
+  lineTo(SIZE, 0);
+  lineTo(0, 0);
+  waitUntilDone();
+  delay(1000);
+
+  Serial.println("Circle");
+  for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
+    float angle = 2.0f * PI * i / CIRCLE_SEGMENTS;
+    lineTo(SIZE / 2 - (int32_t)(SIZE / 2 * cos(angle)), (int32_t)(SIZE / 2 * sin(angle)));
+  }
+  waitUntilDone();
+  delay(2000);
+}
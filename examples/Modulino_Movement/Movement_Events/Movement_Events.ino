@@ -0,0 +1,58 @@
+/*
+ * Modulino Movement - Events
+ *
+ * This example demonstrates motion events detected inside the IMU itself:
+ * taps, free-fall, wake-up and steps. Each poll is a single status read,
+ * and full motion samples are only fetched after a wake-up event, leaving
+ * the I2C bus free for other modules the rest of the time.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoMovement movement;
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  movement.begin();
+
+  // Tap recognition needs a fast accelerometer data rate
+  movement.setAccelerometer(416, 4);
+
+  movement.enableTapDetection(0.6, true);
+  movement.enableFreeFallDetection(312, 6);
+  movement.enableWakeUpDetection(0.2);
+  movement.enablePedometer();
+}
+
+void loop() {
+  uint8_t events = movement.pollEvents();
+
+  if (events & ModulinoMovement::EVENT_SINGLE_TAP) {
+    Serial.println("Tap");
+  }
+  if (events & ModulinoMovement::EVENT_DOUBLE_TAP) {
+    Serial.println("Double tap");
+  }
+  if (events & ModulinoMovement::EVENT_FREE_FALL) {
+    Serial.println("Free fall!");
+  }
+  if (events & ModulinoMovement::EVENT_STEP) {
+    Serial.print("Steps: ");
+    Serial.println(movement.getStepCount());
+  }
+  if (events & ModulinoMovement::EVENT_WAKE_UP) {
+    // Only now read a full sample
+    movement.update();
+    Serial.print("Wake up, acceleration: ");
+    Serial.print(movement.getX(), 2); Serial.print(", ");
+    Serial.print(movement.getY(), 2); Serial.print(", ");
+    Serial.println(movement.getZ(), 2);
+  }
+
+  delay(20);
+}
@@ -0,0 +1,51 @@
+/*
+ * Modulino Movement - FIFO
+ *
+ * This example demonstrates burst reading of motion data from the sensor FIFO.
+ * The IMU stores accelerometer, gyroscope and timestamp data internally, and
+ * the sketch drains many records at once instead of polling every sample.
+ * This keeps the I2C bus free even at high data rates.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoMovement movement;
+
+// Buffer for up to 32 timestamped accel+gyro records
+ModulinoMovement::Sample samples[32];
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  movement.begin();
+
+  if (!movement.beginFifo()) {
+    Serial.println("FIFO configuration failed");
+    while (1);
+  }
+}
+
+void loop() {
+  // Other work can happen here, the sensor keeps collecting samples
+  delay(100);
+
+  size_t count = movement.readFifo(samples, 32);
+  if (movement.fifoOverrun()) {
+    Serial.println("FIFO overrun, samples were lost");
+  }
+  for (size_t i = 0; i < count; i++) {
+    Serial.print(samples[i].timestamp);
+    Serial.print(" us | A: ");
+    Serial.print(samples[i].x, 3); Serial.print(", ");
+    Serial.print(samples[i].y, 3); Serial.print(", ");
+    Serial.print(samples[i].z, 3);
+    Serial.print(" | G: ");
+    Serial.print(samples[i].roll, 1); Serial.print(", ");
+    Serial.print(samples[i].pitch, 1); Serial.print(", ");
+    Serial.println(samples[i].yaw, 1);
+  }
+}
@@ -0,0 +1,49 @@
+/*
+ * Modulino Movement - Fusion
+ *
+ * This example demonstrates orientation estimation with the built-in
+ * Mahony filter. Timestamped samples are drained from the sensor FIFO and
+ * fused into a quaternion, printed as roll, pitch and yaw angles together
+ * with the estimated gyroscope bias.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoMovement movement;
+ModulinoFusion fusion;
+
+ModulinoMovement::Sample samples[16];
+unsigned long lastPrint = 0;
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  movement.begin();
+  movement.setAccelerometer(208, 4);
+  movement.setGyroscope(208, 500);
+  movement.beginFifo();
+}
+
+void loop() {
+  size_t count = movement.readFifo(samples, 16);
+  for (size_t i = 0; i < count; i++) {
+    // integration uses the sensor timestamps, not an assumed rate
+    fusion.update(samples[i]);
+  }
+
+  if (millis() - lastPrint > 100) {
+    lastPrint = millis();
+    Serial.print("Roll: ");
+    Serial.print(fusion.getRoll(), 1);
+    Serial.print("  Pitch: ");
+    Serial.print(fusion.getPitch(), 1);
+    Serial.print("  Yaw: ");
+    Serial.print(fusion.getYaw(), 1);
+    Serial.print("  Gyro bias Z: ");
+    Serial.println(fusion.getGyroBiasZ(), 3);
+  }
+}
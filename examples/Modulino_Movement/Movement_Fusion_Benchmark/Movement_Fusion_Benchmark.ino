@@ -0,0 +1,90 @@
+/*
+ * Modulino Movement - Fusion Benchmark
+ *
+ * This example measures the cost of one orientation filter update for the
+ * floating-point (ModulinoFusion) and fixed-point (ModulinoFusionQ) versions.
+ * It runs on synthetic data, so no module needs to be connected.
+ * On Cortex-M boards with a DWT unit the result is reported in CPU cycles,
+ * elsewhere it is derived from micros().
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+constexpr uint32_t ITERATIONS = 2000;
+constexpr uint32_t PERIOD_US = 4807;  // 208 Hz
+
+ModulinoFusion fusion;
+ModulinoFusionQ fusionQ;
+
+#if defined(DWT) && defined(CoreDebug_DEMCR_TRCENA_Msk)
+#define HAS_CYCLE_COUNTER
+#endif
+
+uint32_t counterStart() {
+#ifdef HAS_CYCLE_COUNTER
+  return DWT->CYCCNT;
+#else
+  return micros();
+#endif
+}
+
+float cyclesPerUpdate(uint32_t start) {
+#ifdef HAS_CYCLE_COUNTER
+  return (float)(DWT->CYCCNT - start) / ITERATIONS;
+#else
+  // micros() based estimate
+  return (float)(micros() - start) * (F_CPU / 1000000UL) / ITERATIONS;
+#endif
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+
+#ifdef HAS_CYCLE_COUNTER
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+  int16_t gyro[3] = { 120, -40, 15 };
+  int16_t accel[3] = { 300, -150, 8100 };
+
+  uint32_t t = 0;
+  uint32_t start = counterStart();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    t += PERIOD_US;
+    fusion.update(7.3f, -2.4f, 0.9f, 0.037f, -0.018f, 0.99f, t);
+  }
+  float floatCycles = cyclesPerUpdate(start);
+
+  t = 0;
+  start = counterStart();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    t += PERIOD_US;
+    fusionQ.update(gyro, accel, t);
+  }
+  float fixedCycles = cyclesPerUpdate(start);
+
+  Serial.print("Float update: ");
+  Serial.print(floatCycles, 1);
+  Serial.println(" cycles");
+  Serial.print("Fixed-point update: ");
+  Serial.print(fixedCycles, 1);
+  Serial.println(" cycles");
+  Serial.print("Attitude check (roll, pitch): ");
+  Serial.print(fusion.getRoll(), 2);
+  Serial.print(", ");
+  Serial.print(fusion.getPitch(), 2);
+  Serial.print(" / ");
+  Serial.print(fusionQ.getRoll(), 2);
+  Serial.print(", ");
+  Serial.println(fusionQ.getPitch(), 2);
+}
+
+void loop() {
+}
@@ -0,0 +1,52 @@
+/*
+ * Modulino Pressure - Altitude
+ *
+ * This example demonstrates continuous barometric sampling. The sensor
+ * fills its FIFO at 25 Hz with the low-pass filter enabled, the sketch
+ * drains it in batches and prints the relative altitude of each record.
+ * The starting point is used as altitude 0.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoPressure pressure;
+
+ModulinoPressure::Sample samples[16];
+
+void setup() {
+  Serial.begin(115200);
+  Modulino.begin();
+  pressure.begin();
+
+  // Use the current pressure as reference, so altitude starts at 0 m
+  pressure.update();
+  pressure.setReferencePressure(pressure.getPressure());
+
+  // 25 Hz, low-pass filter bandwidth ODR/20
+  pressure.beginContinuous(25, 20);
+}
+
+void loop() {
+  int n = pressure.readSeries(samples, 16);
+  for (int i = 0; i < n; i++) {
+    Serial.print(samples[i].timestamp);
+    Serial.print("\t");
+    Serial.print(samples[i].pressure, 3);
+    Serial.print(" kPa\t");
+    Serial.print(samples[i].temperature, 2);
+    Serial.print(" C\t");
+    Serial.print(pressure.pressureToAltitude(samples[i].pressure), 2);
+    Serial.println(" m");
+  }
+
+  if (pressure.fifoOverrun()) {
+    Serial.println("FIFO overrun, some samples were lost");
+  }
+
+  // The FIFO holds 32 records, around 1.3 s at 25 Hz
+  delay(500);
+}
@@ -43,6 +43,9 @@ void setup(){
 }
 
 void loop(){
+  // Take one measurement, temperature and humidity come from the same reading
+  thermo.update();
+
   // Read temperature in Celsius from the sensor
   float celsius = thermo.getTemperature();
 
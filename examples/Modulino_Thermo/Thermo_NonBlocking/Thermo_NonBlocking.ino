@@ -0,0 +1,56 @@
+/*
+ * Modulino Thermo - Non Blocking
+ *
+ * This example demonstrates how to start a temperature and humidity
+ * measurement and collect it later, keeping the loop free while the
+ * sensor converts. The buttons stay responsive the whole time.
+ *
+ * This example code is in the public domain.
+ * Copyright (c) 2025 Arduino
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include <Arduino_Modulino.h>
+
+ModulinoThermo thermo;
+ModulinoButtons buttons;
+
+unsigned long lastStart = 0;
+
+void setup() {
+  Serial.begin(9600);
+  Modulino.begin();
+  thermo.begin();
+  buttons.begin();
+
+  thermo.startMeasurement();
+  lastStart = millis();
+}
+
+void loop() {
+  // Returns immediately until the conversion time has elapsed
+  if (thermo.poll()) {
+    Serial.print("Temperature: ");
+    Serial.print(thermo.getTemperature());
+    Serial.print(" C\tHumidity: ");
+    Serial.print(thermo.getHumidity());
+    Serial.println(" %");
+  }
+
+  // Start a new measurement every second
+  if (millis() - lastStart >= 1000) {
+    thermo.startMeasurement();
+    lastStart = millis();
+  }
+
+  // Other modules are serviced while the sensor converts
+  if (buttons.update()) {
+    for (int i = 0; i < 3; i++) {
+      if (buttons.isPressed(i)) {
+        Serial.print("Button ");
+        Serial.print(i);
+        Serial.println(" pressed");
+      }
+    }
+  }
+}
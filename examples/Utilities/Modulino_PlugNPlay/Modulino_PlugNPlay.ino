@@ -46,6 +46,7 @@ void loop() {
   float y;
   float z;
   // Cycle through LED patterns when encoder is pressed
+  encoder.update();
   if (encoder.isPressed()) {
     skip = (skip + 1) % 5;
   }
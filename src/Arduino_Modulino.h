@@ -1,2 +1,7 @@
 #include "Modulino.h"
 #include "ModulinoMotors.h"
+#include "ModulinoMotorsGroup.h"
+#include "ModulinoFusion.h"
+#include "ModulinoLightPalette.h"
+#include "ModulinoDistanceFilter.h"
+#include "ModulinoDistanceArray.h"
@@ -10,6 +10,7 @@
 #endif
 
 #include "Wire.h"
+#include <new>
 #include <vl53l4cd_class.h>  // from stm32duino
 #include <vl53l4ed_class.h>  // from stm32duino
 #include "Arduino_LSM6DSOX.h"
@@ -81,9 +82,18 @@ class ModulinoHubPort {
 
 class ModulinoHub {
   public:
-    ModulinoHub(int address = 0x70) : _address(address){  }
+    static constexpr int PORTS = 8;
+    ModulinoHub(int address = 0x70) : _address(address),
+      _ports{{0, this}, {1, this}, {2, this}, {3, this}, {4, this}, {5, this}, {6, this}, {7, this}} {  }
+    // the ports point back at this hub, so a copy would share them
+    ModulinoHub(const ModulinoHub&) = delete;
+    ModulinoHub& operator=(const ModulinoHub&) = delete;
+    // ports live inside the hub, so the same pointer is returned on every call
     ModulinoHubPort* port(int _port) {
-      return new ModulinoHubPort(_port, this);
+      if (_port < 0 || _port >= PORTS) {
+        return nullptr;
+      }
+      return &_ports[_port];
     }
     int select(int port) {
       Modulino._wire->beginTransmission(_address);
@@ -101,6 +111,7 @@ class ModulinoHub {
     }
   private:
     int _address;
+    ModulinoHubPort _ports[PORTS];
 };
 
 class Module : public Printable {
@@ -196,11 +207,93 @@ private:
   uint8_t pinstrap_address;
   char* name;
 protected:
+  // Register access for modules that expose a sensor register map directly;
+  // the caller selects the hub port around a sequence of calls
+  static bool readRegisters(uint8_t addr, uint8_t reg, uint8_t* data, size_t length) {
+    getWire()->beginTransmission(addr);
+    getWire()->write(reg);
+    if (getWire()->endTransmission(false) != 0) {
+      return false;
+    }
+    if (getWire()->requestFrom(addr, (uint8_t)length) != length) {
+      return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+      data[i] = getWire()->read();
+    }
+    return true;
+  }
+  static bool writeRegister(uint8_t addr, uint8_t reg, uint8_t value) {
+    getWire()->beginTransmission(addr);
+    getWire()->write(reg);
+    getWire()->write(value);
+    return getWire()->endTransmission() == 0;
+  }
+  static bool modifyRegister(uint8_t addr, uint8_t reg, uint8_t mask, uint8_t value) {
+    uint8_t current;
+    if (!readRegisters(addr, reg, &current, 1)) {
+      return false;
+    }
+    return writeRegister(addr, reg, (current & ~mask) | (value & mask));
+  }
   ModulinoHubPort* hubPort = nullptr;
 };
 
+// Storage for a vendor driver inside the module object; the driver is built in
+// begin() once the bus is known, so no module allocates on the heap
+template<typename T>
+class _driver_storage {
+public:
+  _driver_storage() {}
+  _driver_storage(const _driver_storage&) = delete;
+  _driver_storage& operator=(const _driver_storage&) = delete;
+  ~_driver_storage() {
+    reset();
+  }
+  template<typename... Args>
+  T* emplace(Args&&... args) {
+    reset();
+    driver = new (&storage.object) T(args...);
+    return driver;
+  }
+  void reset() {
+    if (driver != nullptr) {
+      driver->~T();
+      driver = nullptr;
+    }
+  }
+  T* operator->() const {
+    return driver;
+  }
+  explicit operator bool() const {
+    return driver != nullptr;
+  }
+private:
+  union Storage {
+    Storage() {}
+    ~Storage() {}
+    T object;
+  } storage;
+  T* driver = nullptr;
+};
+
 class ModulinoButtons : public Module {
 public:
+  // One gesture event queued by update()
+  struct Event {
+    uint32_t timestamp;  // millis() of the edge or deadline that completed the gesture
+    uint8_t button;      // 0-A, 1-B, 2-C
+    uint8_t type;        // one of the EVENT_* values
+    uint8_t count;       // clicks in the sequence, repeats so far for EVENT_REPEAT
+  };
+  static constexpr uint8_t EVENT_PRESS = 1;
+  static constexpr uint8_t EVENT_RELEASE = 2;
+  static constexpr uint8_t EVENT_CLICK = 3;
+  static constexpr uint8_t EVENT_DOUBLE_CLICK = 4;
+  static constexpr uint8_t EVENT_MULTI_CLICK = 5;
+  static constexpr uint8_t EVENT_LONG_PRESS = 6;
+  static constexpr uint8_t EVENT_REPEAT = 7;
+  static constexpr uint8_t EVENT_QUEUE_LENGTH = 16;
   ModulinoButtons(uint8_t address = 0xFF, ModulinoHubPort* hubPort = nullptr)
     : Module(address, "BUTTONS", hubPort) {}
   ModulinoButtons(ModulinoHubPort* hubPort, uint8_t address = 0xFF)
@@ -219,15 +312,55 @@ public:
     }
     return isPressed(button[0]);
   }
+  // Reads the three buttons in a single transaction and runs the gesture
+  // engine on them. Returns true when any raw button level changed
   bool update() {
     uint8_t buf[3];
     auto res = read((uint8_t*)buf, 3);
-    auto ret = res && (buf[0] != last_status[0] || buf[1] != last_status[1] || buf[2] != last_status[2]);
+    if (!res) {
+      return false;
+    }
+    auto ret = (buf[0] != last_status[0] || buf[1] != last_status[1] || buf[2] != last_status[2]);
     last_status[0] = buf[0];
     last_status[1] = buf[1];
     last_status[2] = buf[2];
+    const uint32_t now = millis();
+    for (uint8_t i = 0; i < 3; i++) {
+      updateGesture(i, last_status[i], now);
+    }
     return ret;
   }
+  // Number of queued gesture events
+  uint8_t available() const {
+    return _eventCount;
+  }
+  // Takes the oldest queued event, returns false when the queue is empty
+  bool readEvent(Event& event) {
+    if (_eventCount == 0) {
+      return false;
+    }
+    event = _events[_eventHead];
+    _eventHead = (_eventHead + 1) % EVENT_QUEUE_LENGTH;
+    _eventCount--;
+    return true;
+  }
+  // Level changes closer than ms to the previous accepted edge are ignored
+  void setDebounce(uint16_t ms) {
+    _debounceMs = ms;
+  }
+  // Longest gap between a release and the next press of the same click
+  // sequence. 0 reports every release as a single click without waiting
+  void setClickTimeout(uint16_t ms) {
+    _clickTimeoutMs = ms;
+  }
+  // Hold time before EVENT_LONG_PRESS, 0 disables long-press and repeat
+  void setLongPress(uint16_t ms) {
+    _longPressMs = ms;
+  }
+  // Interval of EVENT_REPEAT while held past the long-press time, 0 disables it
+  void setRepeat(uint16_t ms) {
+    _repeatMs = ms;
+  }
   void setLeds(bool a, bool b, bool c) {
     uint8_t buf[3];
     buf[0] = a;
@@ -245,7 +378,96 @@ public:
     return 0xFF;
   }
 private:
-  bool last_status[3];
+  struct Gesture {
+    uint32_t edge;     // last accepted edge, for debounce
+    uint32_t since;    // press time while down, release time while up
+    uint32_t next;     // next long-press or repeat deadline
+    bool down;         // debounced level
+    bool held;         // long-press sent for the current press
+    uint8_t clicks;    // clicks in the open sequence
+    uint8_t repeats;
+  };
+  void updateGesture(uint8_t index, bool level, uint32_t now) {
+    Gesture& g = _gestures[index];
+    if (level != g.down && now - g.edge >= _debounceMs) {
+      if (level && g.clicks != 0 && now - g.since >= _clickTimeoutMs) {
+        // the sequence timed out before this update saw the new press
+        closeClicks(index, g.since);
+      }
+      g.edge = now;
+      g.down = level;
+      g.since = now;
+      if (level) {
+        g.held = false;
+        g.repeats = 0;
+        g.next = now + _longPressMs;
+        pushEvent(index, EVENT_PRESS, g.clicks + 1, now);
+      } else {
+        pushEvent(index, EVENT_RELEASE, g.clicks + 1, now);
+        if (g.held) {
+          g.clicks = 0;
+        } else if (++g.clicks == 255 || _clickTimeoutMs == 0) {
+          closeClicks(index, now);
+        }
+      }
+      return;
+    }
+    if (g.down) {
+      if (_longPressMs == 0 || (int32_t)(now - g.next) < 0) {
+        return;
+      }
+      if (!g.held) {
+        // a long press ends the click sequence it follows
+        g.held = true;
+        if (g.clicks != 0) {
+          closeClicks(index, g.since);
+        }
+        pushEvent(index, EVENT_LONG_PRESS, 1, g.next);
+      } else if (_repeatMs != 0) {
+        pushEvent(index, EVENT_REPEAT, ++g.repeats, g.next);
+      }
+      if (_repeatMs == 0) {
+        // nothing more until release; keep the deadline from going stale
+        g.next = now;
+        return;
+      }
+      g.next += _repeatMs;
+      if ((int32_t)(now - g.next) >= 0) {
+        // late update, skip the repeats that were missed instead of bursting
+        g.next = now + _repeatMs;
+      }
+    } else if (g.clicks != 0 && now - g.since >= _clickTimeoutMs) {
+      closeClicks(index, g.since);
+    }
+  }
+  void closeClicks(uint8_t index, uint32_t timestamp) {
+    Gesture& g = _gestures[index];
+    const uint8_t type = g.clicks == 1 ? EVENT_CLICK : (g.clicks == 2 ? EVENT_DOUBLE_CLICK : EVENT_MULTI_CLICK);
+    pushEvent(index, type, g.clicks, timestamp);
+    g.clicks = 0;
+  }
+  // a full queue drops its oldest event, so the newest state is never lost
+  void pushEvent(uint8_t button, uint8_t type, uint8_t count, uint32_t timestamp) {
+    if (_eventCount == EVENT_QUEUE_LENGTH) {
+      _eventHead = (_eventHead + 1) % EVENT_QUEUE_LENGTH;
+      _eventCount--;
+    }
+    Event& event = _events[(_eventHead + _eventCount) % EVENT_QUEUE_LENGTH];
+    event.timestamp = timestamp;
+    event.button = button;
+    event.type = type;
+    event.count = count;
+    _eventCount++;
+  }
+  bool last_status[3] = {false, false, false};
+  Gesture _gestures[3] = {};
+  uint16_t _debounceMs = 20;
+  uint16_t _clickTimeoutMs = 300;
+  uint16_t _longPressMs = 600;
+  uint16_t _repeatMs = 0;
+  Event _events[EVENT_QUEUE_LENGTH];
+  uint8_t _eventHead = 0;
+  uint8_t _eventCount = 0;
   int buttonToIndex(char button) {
     switch (toupper(button)) {
       case 'A': return 0;
@@ -260,36 +482,155 @@ protected:
 
 class ModulinoJoystick : public Module {
 public:
+  // How the dead zone around the center is shaped
+  enum DeadZone : uint8_t {
+    DEAD_ZONE_SQUARE = 0,  // both axes read 0 while each is inside the zone
+    DEAD_ZONE_RADIAL,      // a circle; outside it positions are unchanged
+    DEAD_ZONE_SCALED,      // a circle; outside it the travel is rescaled to start at 0
+  };
+  static constexpr uint8_t MIN_CALIBRATED_SPAN = 16;
   ModulinoJoystick(uint8_t address = 0xFF, ModulinoHubPort* hubPort = nullptr)
     : Module(address, "JOYSTICK", hubPort) {}
   ModulinoJoystick(ModulinoHubPort* hubPort, uint8_t address = 0xFF)
     : Module(address, "JOYSTICK", hubPort) {}
+  // Reads the stick once and runs it through calibration, dead zone and
+  // response curve. Returns true only when an axis moved by at least the
+  // change threshold, came back to center or reached full deflection, or
+  // the button changed
   bool update() {
     uint8_t buf[3];
     auto res = read((uint8_t*)buf, 3);
-    auto x = buf[0];
-    auto y =  buf[1];
-    map_value(x, y);
-    auto ret = res && (x != last_status[0] || y != last_status[1] || buf[2] != last_status[2]);
+    if (!res) {
+      return false;
+    }
+    _rawX = buf[0];
+    _rawY = buf[1];
+    if (_calibrating) {
+      _minX = min(_minX, _rawX);
+      _maxX = max(_maxX, _rawX);
+      _minY = min(_minY, _rawY);
+      _maxY = max(_maxY, _rawY);
+    }
+    int16_t x = normalize(_rawX, _centerX, _minX, _maxX);
+    int16_t y = normalize(_rawY, _centerY, _minY, _maxY);
+    applyDeadZone(x, y);
+    x = curve(x);
+    y = curve(y);
+
+    const bool pressed = buf[2] != 0;
+    const uint8_t threshold = _threshold > 0 ? _threshold : 1;
+    const bool centered = x == 0 && y == 0 && (last_status[0] != 0 || last_status[1] != 0);
+    // like the center, the ends of travel are always reachable
+    const bool edge = (abs(x) == 127 && x != last_status[0]) || (abs(y) == 127 && y != last_status[1]);
+    auto ret = centered || edge || pressed != (last_status[2] != 0) ||
+      abs(x - last_status[0]) >= threshold || abs(y - last_status[1]) >= threshold;
     if (!ret) {
       return false;
     }
     last_status[0] = x;
     last_status[1] = y;
-    last_status[2] = buf[2];
+    last_status[2] = pressed;
     return ret;
   }
+  // Radius (or half side for DEAD_ZONE_SQUARE) of the dead zone, in the
+  // -127..127 units returned by getX() and getY()
   void setDeadZone(uint8_t dz_th) {
     _dz_threshold = dz_th;
   }
+  void setDeadZone(uint8_t dz_th, DeadZone shape) {
+    _dz_threshold = dz_th;
+    _dz_shape = shape;
+  }
+  // Blends a linear response (0) with a cubic one (255): higher values give
+  // finer control around the center and keep full travel at the edges
+  void setExpo(uint8_t expo) {
+    _expo = expo;
+  }
+  // Smallest axis movement that update() reports as a change, 1 reports all
+  void setChangeThreshold(uint8_t threshold) {
+    _threshold = threshold;
+  }
+  // Takes the current position of the released stick as its center
+  bool calibrateCenter(uint8_t samples = 8) {
+    uint16_t sumX = 0;
+    uint16_t sumY = 0;
+    if (samples == 0) {
+      samples = 1;
+    }
+    for (uint8_t i = 0; i < samples; i++) {
+      uint8_t buf[3];
+      if (!read(buf, 3)) {
+        return false;
+      }
+      sumX += buf[0];
+      sumY += buf[1];
+    }
+    setCenter((sumX + samples / 2) / samples, (sumY + samples / 2) / samples);
+    return true;
+  }
+  void setCenter(uint8_t x, uint8_t y) {
+    _centerX = x;
+    _centerY = y;
+  }
+  // Raw readings that map to full deflection on each side
+  void setRange(uint8_t minX, uint8_t maxX, uint8_t minY, uint8_t maxY) {
+    _minX = minX;
+    _maxX = maxX;
+    _minY = minY;
+    _maxY = maxY;
+  }
+  // Between these calls every update() widens the range to the raw readings
+  // seen, so the stick should be moved all around its travel. A side that
+  // moved less than MIN_CALIBRATED_SPAN keeps its previous extent, and
+  // endRangeCalibration() then returns false so the sketch can retry
+  void beginRangeCalibration() {
+    _saved[0] = _minX;
+    _saved[1] = _maxX;
+    _saved[2] = _minY;
+    _saved[3] = _maxY;
+    _minX = _maxX = _centerX;
+    _minY = _maxY = _centerY;
+    _calibrating = true;
+  }
+  bool endRangeCalibration() {
+    if (!_calibrating) {
+      return false;
+    }
+    _calibrating = false;
+    bool ok = true;
+    if (_centerX - _minX < MIN_CALIBRATED_SPAN) {
+      _minX = _saved[0];
+      ok = false;
+    }
+    if (_maxX - _centerX < MIN_CALIBRATED_SPAN) {
+      _maxX = _saved[1];
+      ok = false;
+    }
+    if (_centerY - _minY < MIN_CALIBRATED_SPAN) {
+      _minY = _saved[2];
+      ok = false;
+    }
+    if (_maxY - _centerY < MIN_CALIBRATED_SPAN) {
+      _maxY = _saved[3];
+      ok = false;
+    }
+    return ok;
+  }
   PinStatus isPressed() {
     return last_status[2] ? HIGH : LOW;
   }
   int8_t getX() {
-    return (last_status[0] < 128 ? (128 - last_status[0]) : -(last_status[0] - 128));
+    return last_status[0];
   }
   int8_t getY() {
-    return (last_status[1] < 128 ? (128 - last_status[1]) : -(last_status[1] - 128));
+    return last_status[1];
+  }
+  // Readings of the last update() before any processing
+  uint8_t getRawX() const {
+    return _rawX;
+  }
+  uint8_t getRawY() const {
+    return _rawY;
   }
   virtual uint8_t discover() {
     for (unsigned int i = 0; i < sizeof(match)/sizeof(match[0]); i++) {
@@ -299,15 +640,86 @@ public:
     }
     return 0xFF;
   }
-  void map_value(uint8_t &x, uint8_t &y) {
-    if (x > 128 - _dz_threshold &&  x < 128 + _dz_threshold && y > 128 - _dz_threshold && y < 128 + _dz_threshold) {
-        x = 128;
-        y = 128;
+private:
+  // Maps a raw reading to -127..127 with each side scaled to its own
+  // extent; low raw values give positive output as before
+  static int16_t normalize(uint8_t raw, uint8_t center, uint8_t low, uint8_t high) {
+    int16_t offset = (int16_t)center - raw;
+    int16_t span = offset > 0 ? center - low : high - center;
+    if (span <= 0) {
+      return 0;
     }
+    int16_t v = (int32_t)offset * 127 / span;
+    return v > 127 ? 127 : (v < -127 ? -127 : v);
+  }
+  void applyDeadZone(int16_t& x, int16_t& y) const {
+    const int16_t dz = _dz_threshold;
+    if (dz == 0) {
+      return;
+    }
+    if (_dz_shape == DEAD_ZONE_SQUARE) {
+      if (abs(x) < dz && abs(y) < dz) {
+        x = 0;
+        y = 0;
+      }
+      return;
+    }
+    const uint16_t magnitude = isqrt((int32_t)x * x + (int32_t)y * y);
+    if (magnitude < dz || dz >= 127) {
+      x = 0;
+      y = 0;
+      return;
+    }
+    if (_dz_shape == DEAD_ZONE_SCALED) {
+      // move the dead zone edge to 0 and keep the direction
+      const int32_t scaled = (int32_t)(magnitude - dz) * 127 / (127 - dz);
+      x = clamp127((int32_t)x * scaled / magnitude);
+      y = clamp127((int32_t)y * scaled / magnitude);
+    }
+  }
+  // (256 - e) * x + e * x^3, all in Q8 with x scaled to +-127
+  int16_t curve(int16_t x) const {
+    if (_expo == 0) {
+      return x;
+    }
+    const int32_t cube = (int32_t)x * x * x / (127 * 127);
+    return ((256 - _expo) * (int32_t)x + _expo * cube) / 256;
+  }
+  static int16_t clamp127(int32_t v) {
+    return v > 127 ? 127 : (v < -127 ? -127 : v);
+  }
+  static uint16_t isqrt(uint32_t v) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > v) {
+      bit >>= 2;
+    }
+    while (bit != 0) {
+      if (v >= root + bit) {
+        v -= root + bit;
+        root = (root >> 1) + bit;
+      } else {
+        root >>= 1;
+      }
+      bit >>= 2;
+    }
+    return root;
   }
-private:
   uint8_t _dz_threshold = 26;
-  uint8_t last_status[3];
+  DeadZone _dz_shape = DEAD_ZONE_SQUARE;
+  uint8_t _expo = 0;
+  uint8_t _threshold = 1;
+  uint8_t _centerX = 128;
+  uint8_t _centerY = 128;
+  uint8_t _minX = 0;
+  uint8_t _maxX = 255;
+  uint8_t _minY = 0;
+  uint8_t _maxY = 255;
+  bool _calibrating = false;
+  uint8_t _saved[4];  // extents before beginRangeCalibration()
+  uint8_t _rawX = 128;
+  uint8_t _rawY = 128;
+  int8_t last_status[3] = {0, 0, 0};
 protected:
   uint8_t match[1] = { 0x58 };  // same as fw main.c
 };
@@ -444,61 +856,140 @@ public:
     : Module(address, "ENCODER", hubPort) {}
   ModulinoKnob(ModulinoHubPort* hubPort, uint8_t address = 0xFF)
     : Module(address, "ENCODER", hubPort) {}
-    bool begin() {
+  // One input event queued by update()
+  struct Event {
+    uint32_t timestamp;  // millis() when update() saw it
+    uint8_t type;        // one of the EVENT_* values
+    int16_t delta;       // accelerated detents for EVENT_ROTATE, 0 otherwise
+  };
+  static constexpr uint8_t EVENT_ROTATE = 1;
+  static constexpr uint8_t EVENT_PRESS = 2;
+  static constexpr uint8_t EVENT_RELEASE = 3;
+  static constexpr uint8_t EVENT_LONG_PRESS = 4;
+  static constexpr uint8_t EVENT_QUEUE_LENGTH = 8;
+  bool begin() {
     auto ret = Module::begin();
     if (ret) {
-      auto _val = get();
-      _lastPosition = _val;
-      _lastDebounceTime = millis();
-      set(100);
-      if (get() != 100) {
-        _bug_on_set = true;
-        set(-_val);
+      int16_t value;
+      if (!readState(value)) {
+        // without a reading the set() probe cannot run
+        return false;
+      }
+      // older firmware negates the value written by set(); the probe moves
+      // the knob position, so its result is kept for every later begin()
+      Probe* probe = findProbe(hubPort, getAddress());
+      if (probe != nullptr) {
+        _bug_on_set = probe->bug;
       } else {
-        set(_val);
+        int16_t check;
+        writeRaw(100);
+        _bug_on_set = readState(check) && check != 100;
+        writeRaw(value);
+        rememberProbe(hubPort, getAddress(), _bug_on_set);
       }
+      _position = value;
+      _direction = 0;
+      _resync = true;
+      _button = _pressed;
+      _longPressSent = _pressed;
+      _pressTime = millis();
+      _lastRotation = millis();
+      _delta = 0;
+      _remainder = 0;
+      _eventCount = 0;
     }
     return ret;
   }
-  int16_t get() {
-    uint8_t buf[3];
-    auto res = read(buf, 3);
-    if (res == false) {
-      return 0;
+  // Takes a snapshot of position and button in a single read, accumulates
+  // the (accelerated) rotation and queues rotate, press, release and
+  // long-press events. The getters below only return this snapshot.
+  // Returns true when anything changed
+  bool update() {
+    int16_t position;
+    if (!readState(position)) {
+      return false;
     }
-    _pressed = (buf[2] != 0);
-    int16_t ret = buf[0] | (buf[1] << 8);
-    return ret;
+    const uint32_t now = millis();
+    bool changed = false;
+
+    // the difference of two int16 wraps correctly past +-32767
+    const int16_t steps = _resync ? 0 : (int16_t)(position - _position);
+    _position = position;
+    _resync = false;
+    _direction = steps > 0 ? 1 : (steps < 0 ? -1 : 0);
+    if (steps != 0) {
+      const int16_t delta = accelerate(steps, now);
+      _delta += delta;
+      pushEvent(EVENT_ROTATE, delta, now);
+      changed = true;
+    }
+
+    if (_pressed != _button) {
+      _button = _pressed;
+      if (_pressed) {
+        _pressTime = now;
+        _longPressSent = false;
+      }
+      pushEvent(_pressed ? EVENT_PRESS : EVENT_RELEASE, 0, now);
+      changed = true;
+    } else if (_pressed && !_longPressSent && _longPressMs != 0 && now - _pressTime >= _longPressMs) {
+      _longPressSent = true;
+      pushEvent(EVENT_LONG_PRESS, 0, now);
+      changed = true;
+    }
+    return changed;
+  }
+  // Returns the detents turned since the last call, after acceleration
+  int32_t getDelta() {
+    const int32_t delta = _delta;
+    _delta = 0;
+    return delta;
+  }
+  // Number of queued events
+  uint8_t available() const {
+    return _eventCount;
+  }
+  // Takes the oldest queued event, returns false when the queue is empty
+  bool readEvent(Event& event) {
+    if (_eventCount == 0) {
+      return false;
+    }
+    event = _events[_eventHead];
+    _eventHead = (_eventHead + 1) % EVENT_QUEUE_LENGTH;
+    _eventCount--;
+    return true;
+  }
+  // Scales rotation by up to maxFactor when spinning fast. Below startSpeed
+  // detents/s every detent counts once, at fullSpeed and above it counts
+  // maxFactor times, with a linear ramp in between. maxFactor 1 disables it
+  void setAcceleration(uint8_t maxFactor, uint16_t startSpeed = 10, uint16_t fullSpeed = 60) {
+    _accelMax = maxFactor > 0 ? maxFactor : 1;
+    _accelStart = startSpeed;
+    _accelFull = fullSpeed > startSpeed ? fullSpeed : startSpeed + 1;
+    _remainder = 0;
+  }
+  // Hold time before EVENT_LONG_PRESS is queued, 0 disables it
+  void setLongPress(uint16_t ms) {
+    _longPressMs = ms;
+  }
+  // Position at the last update()
+  int16_t get() const {
+    return _position;
   }
   void set(int16_t value) {
-    if (_bug_on_set) {
-      value = -value;
-    }
-    uint8_t buf[4];
-    memcpy(buf, &value, 2);
-    write(buf, 4);
+    writeRaw(_bug_on_set ? -value : value);
+    _position = value;
+    // a programmatic jump is not a rotation
+    _resync = true;
   }
-  bool isPressed() {
-    get();
+  // Button state at the last update()
+  bool isPressed() const {
     return _pressed;
   }
-  int8_t getDirection() {
-    unsigned long now = millis();
-    if (now - _lastDebounceTime < DEBOUNCE_DELAY) {
-      return 0;
-    }
-    int16_t current = get();
-    int8_t direction = 0;
-    if (current > _lastPosition) {
-      direction = 1;
-    } else if (current < _lastPosition) {
-      direction = -1;
-    }
-    if (direction != 0) {
-      _lastDebounceTime = now;
-      _lastPosition = current;
-    }
-    return direction;
+  // Direction of the rotation seen by the last update(): 1 clockwise,
+  // -1 counter-clockwise, 0 none
+  int8_t getDirection() const {
+    return _direction;
   }
   virtual uint8_t discover() {
     for (unsigned int i = 0; i < sizeof(match)/sizeof(match[0]); i++) {
@@ -509,11 +1000,110 @@ public:
     return 0xFF;
   }
 private:
+  // Q8 fixed-point speed factor; the fractional part is carried so slow
+  // turns at a factor like 1.5 still alternate between 1 and 2 detents
+  int16_t accelerate(int16_t steps, uint32_t now) {
+    uint32_t dt = now - _lastRotation;
+    _lastRotation = now;
+    if (_accelMax <= 1) {
+      return steps;
+    }
+    if (dt == 0) {
+      dt = 1;
+    }
+    const uint32_t count = steps < 0 ? -steps : steps;
+    const uint32_t speed = count * 1000UL / dt;
+    int32_t factor = 256;
+    if (speed >= _accelFull) {
+      factor = (int32_t)_accelMax * 256;
+    } else if (speed > _accelStart) {
+      factor += (int32_t)(_accelMax - 1) * 256 * (speed - _accelStart) / (_accelFull - _accelStart);
+    }
+    if ((steps < 0) != (_remainder < 0)) {
+      _remainder = 0;
+    }
+    const int32_t scaled = (int32_t)steps * factor + _remainder;
+    const int32_t delta = scaled / 256;
+    _remainder = scaled - delta * 256;
+    return delta;
+  }
+  // a full queue drops its oldest event, so the newest state is never lost
+  void pushEvent(uint8_t type, int16_t delta, uint32_t now) {
+    if (_eventCount == EVENT_QUEUE_LENGTH) {
+      _eventHead = (_eventHead + 1) % EVENT_QUEUE_LENGTH;
+      _eventCount--;
+    }
+    Event& event = _events[(_eventHead + _eventCount) % EVENT_QUEUE_LENGTH];
+    event.timestamp = now;
+    event.type = type;
+    event.delta = delta;
+    _eventCount++;
+  }
+  bool readState(int16_t& position) {
+    uint8_t buf[3];
+    if (!read(buf, 3)) {
+      return false;
+    }
+    position = buf[0] | (buf[1] << 8);
+    _pressed = (buf[2] != 0);
+    return true;
+  }
+  void writeRaw(int16_t value) {
+    uint8_t buf[4];
+    memcpy(buf, &value, 2);
+    write(buf, 4);
+  }
+  // probe results keyed by hub port and address, so knobs sharing an
+  // address behind different ports keep their own result
+  struct Probe {
+    ModulinoHubPort* port;
+    uint8_t address;  // 0xFF marks a free entry
+    bool bug;
+  };
+  static constexpr uint8_t PROBE_CACHE_LENGTH = 8;
+  static Probe* probeCache() {
+    static Probe cache[PROBE_CACHE_LENGTH] = {
+      {nullptr, 0xFF, false}, {nullptr, 0xFF, false}, {nullptr, 0xFF, false}, {nullptr, 0xFF, false},
+      {nullptr, 0xFF, false}, {nullptr, 0xFF, false}, {nullptr, 0xFF, false}, {nullptr, 0xFF, false}};
+    return cache;
+  }
+  static Probe* findProbe(ModulinoHubPort* port, uint8_t address) {
+    Probe* cache = probeCache();
+    for (uint8_t i = 0; i < PROBE_CACHE_LENGTH; i++) {
+      if (cache[i].address == address && cache[i].port == port) {
+        return &cache[i];
+      }
+    }
+    return nullptr;
+  }
+  // a full cache overwrites its oldest entry, which is only probed again
+  static void rememberProbe(ModulinoHubPort* port, uint8_t address, bool bug) {
+    static uint8_t next = 0;
+    Probe& entry = probeCache()[next];
+    next = (next + 1) % PROBE_CACHE_LENGTH;
+    entry.port = port;
+    entry.address = address;
+    entry.bug = bug;
+  }
   bool _pressed = false;
   bool _bug_on_set = false;
-  int16_t _lastPosition = 0;
-  unsigned long _lastDebounceTime = 0;
-  static constexpr unsigned long DEBOUNCE_DELAY = 30;
+  int8_t _direction = 0;
+  // update() state
+  int16_t _position = 0;
+  bool _resync = true;
+  int32_t _delta = 0;
+  int32_t _remainder = 0;
+  uint32_t _lastRotation = 0;
+  uint8_t _accelMax = 1;
+  uint16_t _accelStart = 10;
+  uint16_t _accelFull = 60;
+  bool _button = false;
+  bool _longPressSent = false;
+  uint32_t _pressTime = 0;
+  uint16_t _longPressMs = 600;
+  Event _events[EVENT_QUEUE_LENGTH];
+  uint8_t _eventHead = 0;
+  uint8_t _eventCount = 0;
 protected:
   uint8_t match[2] = { 0x74, 0x76 };
 };
@@ -529,6 +1119,19 @@ extern ModulinoColor WHITE;
 
 class ModulinoMovement : public Module {
 public:
+  // One accel+gyro record drained from the FIFO
+  struct Sample {
+    uint32_t timestamp;  // sensor timestamp in microseconds, wraps like micros()
+    float x, y, z;
+    float roll, pitch, yaw;
+  };
+  // Flags returned by pollEvents()
+  static constexpr uint8_t EVENT_FREE_FALL = 0x01;
+  static constexpr uint8_t EVENT_WAKE_UP = 0x02;
+  static constexpr uint8_t EVENT_SINGLE_TAP = 0x04;
+  static constexpr uint8_t EVENT_DOUBLE_TAP = 0x08;
+  static constexpr uint8_t EVENT_STEP = 0x10;
+  static constexpr uint8_t EVENT_DATA_READY = 0x20;
   ModulinoMovement(uint8_t address = 0x6A, ModulinoHubPort* hubPort = nullptr)
     : Module(address, "MOVEMENT", hubPort) {}
   ModulinoMovement(ModulinoHubPort* hubPort, uint8_t address = 0x6A)
@@ -537,10 +1140,18 @@ public:
     if (hubPort != nullptr) {
       hubPort->select();
     }
-    if (_imu == nullptr) {
-      _imu = new LSM6DSOXClass(*((TwoWire*)getWire()), getAddress());
+    if (!_imu) {
+      _imu.emplace(*((TwoWire*)getWire()), getAddress());
     }
     initialized = _imu->begin();
+    if (initialized) {
+      // block data update, so a burst never mixes halves of two samples
+      uint8_t ctrl3;
+      if (readRegisters(getAddress(), LSM6DSOX_CTRL3_C, &ctrl3, 1)) {
+        writeRegister(getAddress(), LSM6DSOX_CTRL3_C, ctrl3 | 0x40);
+      }
+      readScales();
+    }
     __increaseI2CPriority();
     if (hubPort != nullptr) {
       hubPort->clear();
@@ -550,17 +1161,286 @@ public:
   operator bool() {
     return (initialized != 0);
   }
+  // Output data rate in Hz (rounded up to 12.5 ... 6664 Hz, 0 powers the
+  // accelerometer down) and full scale in g (2, 4, 8, 16)
+  bool setAccelerometer(uint16_t odrHz, uint8_t rangeG) {
+    uint8_t fs;
+    switch (rangeG) {
+      case 2: fs = 0x00; break;
+      case 16: fs = 0x01; break;
+      case 4: fs = 0x02; break;
+      case 8: fs = 0x03; break;
+      default: return false;
+    }
+    // keep LPF2_XL_EN as set by LSM6DSOXClass
+    return writeControl(LSM6DSOX_CTRL1_XL, 0x02, odrCode(odrHz), fs << 2);
+  }
+  // Output data rate in Hz (rounded up to 12.5 ... 6664 Hz, 0 powers the
+  // gyroscope down) and full scale in dps (125, 250, 500, 1000, 2000)
+  bool setGyroscope(uint16_t odrHz, uint16_t rangeDps) {
+    uint8_t fs;
+    switch (rangeDps) {
+      case 125: fs = 0x02; break;
+      case 250: fs = 0x00; break;
+      case 500: fs = 0x04; break;
+      case 1000: fs = 0x08; break;
+      case 2000: fs = 0x0C; break;
+      default: return false;
+    }
+    return writeControl(LSM6DSOX_CTRL2_G, 0x00, odrCode(odrHz), fs);
+  }
+  // Tap recognition runs on the sensor; it works best with the accelerometer
+  // at 416 Hz or more. Threshold in g, limited by the accelerometer full scale
+  bool enableTapDetection(float thresholdG = 0.5, bool doubleTap = false) {
+    uint8_t ths = eventThreshold(thresholdG, 32, 1, 31);
+    return configureEvents([&]() {
+      // tap on X, Y and Z
+      return modifyRegister(getAddress(), LSM6DSOX_TAP_CFG0, 0x0E, 0x0E) &&
+        modifyRegister(getAddress(), LSM6DSOX_TAP_CFG1, 0x1F, ths) &&
+        modifyRegister(getAddress(), LSM6DSOX_TAP_CFG2, 0x1F, ths) &&
+        modifyRegister(getAddress(), LSM6DSOX_TAP_THS_6D, 0x1F, ths) &&
+        // double tap needs a longer duration window
+        writeRegister(getAddress(), LSM6DSOX_INT_DUR2, doubleTap ? 0x7F : 0x06) &&
+        modifyRegister(getAddress(), LSM6DSOX_WAKE_UP_THS, 0x80, doubleTap ? 0x80 : 0x00) &&
+        modifyRegister(getAddress(), LSM6DSOX_MD1_CFG, 0x48, doubleTap ? 0x48 : 0x40);
+    });
+  }
+  // Threshold in mg, rounded down to 156, 219, 250, 312, 344, 406, 469 or 500;
+  // duration in accelerometer samples (0..63)
+  bool enableFreeFallDetection(uint16_t thresholdMg = 312, uint8_t durationSamples = 6) {
+    static const uint16_t thresholds[] = { 156, 219, 250, 312, 344, 406, 469, 500 };
+    uint8_t ths = 0;
+    while (ths < 7 && thresholds[ths + 1] <= thresholdMg) {
+      ths++;
+    }
+    durationSamples &= 0x3F;
+    return configureEvents([&]() {
+      return writeRegister(getAddress(), LSM6DSOX_FREE_FALL, ((durationSamples & 0x1F) << 3) | ths) &&
+        modifyRegister(getAddress(), LSM6DSOX_WAKE_UP_DUR, 0x80, (durationSamples & 0x20) << 2) &&
+        modifyRegister(getAddress(), LSM6DSOX_MD1_CFG, 0x10, 0x10);
+    });
+  }
+  // Threshold in g, limited by the accelerometer full scale; duration in
+  // accelerometer samples (0..3)
+  bool enableWakeUpDetection(float thresholdG = 0.1, uint8_t durationSamples = 0) {
+    uint8_t ths = eventThreshold(thresholdG, 64, 0, 63);
+    return configureEvents([&]() {
+      // slope filter, threshold LSB is full scale / 64
+      return modifyRegister(getAddress(), LSM6DSOX_TAP_CFG0, 0x10, 0x00) &&
+        modifyRegister(getAddress(), LSM6DSOX_WAKE_UP_THS, 0x3F, ths) &&
+        modifyRegister(getAddress(), LSM6DSOX_WAKE_UP_DUR, 0x70, (durationSamples & 0x03) << 5) &&
+        modifyRegister(getAddress(), LSM6DSOX_MD1_CFG, 0x20, 0x20);
+    });
+  }
+  // Step detector and counter, needs the accelerometer at 26 Hz or more
+  bool enablePedometer() {
+    auto ok = configureEvents([&]() {
+      // EMB_FUNC_LIR: latch the step flag like the basic sources, so a
+      // poll slower than one ODR period still sees it
+      return writeRegister(getAddress(), LSM6DSOX_FUNC_CFG_ACCESS, 0x80) &&
+        modifyRegister(getAddress(), LSM6DSOX_EMB_FUNC_EN_A, 0x08, 0x08) &&
+        modifyRegister(getAddress(), LSM6DSOX_EMB_FUNC_INT1, 0x08, 0x08) &&
+        modifyRegister(getAddress(), LSM6DSOX_PAGE_RW, 0x80, 0x80) &&
+        writeRegister(getAddress(), LSM6DSOX_FUNC_CFG_ACCESS, 0x00) &&
+        modifyRegister(getAddress(), LSM6DSOX_MD1_CFG, 0x02, 0x02);
+    });
+    _pedometer = _pedometer || ok;
+    return ok;
+  }
+  // Turn off all event engines
+  bool disableEvents() {
+    _pedometer = false;
+    return configureEvents([&]() {
+      return writeRegister(getAddress(), LSM6DSOX_MD1_CFG, 0x00) &&
+        modifyRegister(getAddress(), LSM6DSOX_TAP_CFG2, 0x80, 0x00) &&
+        writeRegister(getAddress(), LSM6DSOX_FUNC_CFG_ACCESS, 0x80) &&
+        modifyRegister(getAddress(), LSM6DSOX_EMB_FUNC_EN_A, 0x08, 0x00) &&
+        modifyRegister(getAddress(), LSM6DSOX_EMB_FUNC_INT1, 0x08, 0x00) &&
+        modifyRegister(getAddress(), LSM6DSOX_PAGE_RW, 0x80, 0x00) &&
+        writeRegister(getAddress(), LSM6DSOX_FUNC_CFG_ACCESS, 0x00);
+    });
+  }
+  // Events fired since the last call (EVENT_* flags) from one burst read of
+  // the latched sources and STATUS_REG; one more read when the pedometer is on.
+  // Only call update() when EVENT_DATA_READY or another event is reported.
+  uint8_t pollEvents() {
+    if (!initialized) {
+      return 0;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    // ALL_INT_SRC, WAKE_UP_SRC, TAP_SRC, D6D_SRC, STATUS_REG
+    uint8_t src[5];
+    uint8_t events = 0;
+    if (readRegisters(getAddress(), LSM6DSOX_ALL_INT_SRC, src, 5)) {
+      events = src[0] & (EVENT_FREE_FALL | EVENT_WAKE_UP | EVENT_SINGLE_TAP | EVENT_DOUBLE_TAP);
+      if ((src[4] & 0x03) == 0x03) {
+        events |= EVENT_DATA_READY;
+      }
+    }
+    uint8_t emb = 0;
+    if (_pedometer && readRegisters(getAddress(), LSM6DSOX_EMB_FUNC_STATUS_MAINPAGE, &emb, 1) && (emb & 0x08)) {
+      events |= EVENT_STEP;
+    }
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    return events;
+  }
+  uint16_t getStepCount() {
+    if (!initialized) {
+      return 0;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    uint8_t buf[2] = { 0, 0 };
+    if (writeRegister(getAddress(), LSM6DSOX_FUNC_CFG_ACCESS, 0x80)) {
+      readRegisters(getAddress(), LSM6DSOX_STEP_COUNTER_L, buf, 2);
+      writeRegister(getAddress(), LSM6DSOX_FUNC_CFG_ACCESS, 0x00);
+    }
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    return buf[0] | (buf[1] << 8);
+  }
+  bool resetStepCount() {
+    return configureEvents([&]() {
+      return writeRegister(getAddress(), LSM6DSOX_FUNC_CFG_ACCESS, 0x80) &&
+        modifyRegister(getAddress(), LSM6DSOX_EMB_FUNC_SRC, 0x80, 0x80) &&
+        writeRegister(getAddress(), LSM6DSOX_FUNC_CFG_ACCESS, 0x00);
+    });
+  }
+  // Batch accel, gyro and timestamps into the sensor FIFO at the configured
+  // data rates; drain it with readFifo() instead of calling update()/available()
+  bool beginFifo(uint16_t watermark = 0) {
+    if (!initialized) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    uint8_t ctrl[2];  // CTRL1_XL, CTRL2_G
+    uint8_t ctrl10 = 0;
+    bool ok = readRegisters(getAddress(), LSM6DSOX_CTRL1_XL, ctrl, 2) && readRegisters(getAddress(), LSM6DSOX_CTRL10_C, &ctrl10, 1);
+    // bypass mode empties the FIFO
+    ok = ok && writeRegister(getAddress(), LSM6DSOX_FIFO_CTRL4, 0x00);
+    ok = ok && writeRegister(getAddress(), LSM6DSOX_CTRL10_C, ctrl10 | 0x20);  // TIMESTAMP_EN
+    ok = ok && writeRegister(getAddress(), LSM6DSOX_FIFO_CTRL1, watermark & 0xFF);
+    ok = ok && writeRegister(getAddress(), LSM6DSOX_FIFO_CTRL2, (watermark >> 8) & 0x01);
+    // batch data rates follow the output data rates
+    ok = ok && writeRegister(getAddress(), LSM6DSOX_FIFO_CTRL3, (ctrl[1] & 0xF0) | (ctrl[0] >> 4));
+    // timestamp batched every record, continuous mode
+    ok = ok && writeRegister(getAddress(), LSM6DSOX_FIFO_CTRL4, 0x40 | 0x06);
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    if (ok) {
+      readScales();
+      _fifoPending = 0;
+      _fifoTimestamp = 0;
+      _fifoOverrun = false;
+    }
+    return ok;
+  }
+  bool endFifo() {
+    if (!initialized) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    auto ok = writeRegister(getAddress(), LSM6DSOX_FIFO_CTRL4, 0x00);
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    return ok;
+  }
+  // Unread FIFO words; each record takes three (accel, gyro, timestamp)
+  int fifoAvailable() {
+    if (!initialized) {
+      return 0;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    uint8_t status[2];
+    auto ok = readRegisters(getAddress(), LSM6DSOX_FIFO_STATUS1, status, 2);
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    if (!ok) {
+      return 0;
+    }
+    _fifoOverrun = _fifoOverrun || (status[1] & 0x40);
+    return status[0] | ((status[1] & 0x03) << 8);
+  }
+  // True if records were lost because the FIFO filled up, cleared by reading it
+  bool fifoOverrun() {
+    auto ret = _fifoOverrun;
+    _fifoOverrun = false;
+    return ret;
+  }
+  // Drain up to maxSamples records with one status read and burst reads of
+  // FIFO_BURST_WORDS words each; returns the number of records written
+  size_t readFifo(Sample* samples, size_t maxSamples) {
+    if (!initialized || samples == nullptr || maxSamples == 0) {
+      return 0;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    size_t count = 0;
+    uint8_t status[2];
+    if (readRegisters(getAddress(), LSM6DSOX_FIFO_STATUS1, status, 2)) {
+      _fifoOverrun = _fifoOverrun || (status[1] & 0x40);
+      uint16_t words = status[0] | ((status[1] & 0x03) << 8);
+      uint8_t buf[FIFO_BURST_WORDS * 7];
+      while (words > 0 && count < maxSamples) {
+        uint8_t n = words < FIFO_BURST_WORDS ? words : FIFO_BURST_WORDS;
+        // don't pull more words than the remaining records can hold
+        if ((maxSamples - count) * 3 < n) {
+          n = (maxSamples - count) * 3;
+        }
+        // the address rolls back from FIFO_DATA_OUT_Z_H to FIFO_DATA_OUT_TAG
+        if (!readRegisters(getAddress(), LSM6DSOX_FIFO_DATA_OUT_TAG, buf, n * 7)) {
+          break;
+        }
+        for (uint8_t i = 0; i < n && count < maxSamples; i++) {
+          if (decodeFifoWord(&buf[i * 7], samples[count])) {
+            count++;
+          }
+        }
+        words -= n;
+      }
+    }
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    return count;
+  }
   int update() {
     if (initialized) {
       if (hubPort != nullptr) {
         hubPort->select();
       }
-      int accel = _imu->readAcceleration(x, y, z);
-      int gyro = _imu->readGyroscope(roll, pitch, yaw);
+      // gyro and accel outputs are contiguous: one 12-byte burst from OUTX_L_G
+      uint8_t buf[12];
+      auto ret = readRegisters(getAddress(), LSM6DSOX_OUTX_L_G, buf, 12);
       if (hubPort != nullptr) {
         hubPort->clear();
       }
-      return accel && gyro;
+      if (!ret) {
+        return 0;
+      }
+      roll = toInt16(&buf[0]) * _gyroScale;
+      pitch = toInt16(&buf[2]) * _gyroScale;
+      yaw = toInt16(&buf[4]) * _gyroScale;
+      x = toInt16(&buf[6]) * _accelScale;
+      y = toInt16(&buf[8]) * _accelScale;
+      z = toInt16(&buf[10]) * _accelScale;
+      return 1;
     }
     return 0;
   }
@@ -569,11 +1449,13 @@ public:
       if (hubPort != nullptr) {
         hubPort->select();
       }
-      auto ret = _imu->accelerationAvailable() && _imu->gyroscopeAvailable();
+      uint8_t status = 0;
+      auto ok = readRegisters(getAddress(), LSM6DSOX_STATUS_REG, &status, 1);
       if (hubPort != nullptr) {
         hubPort->clear();
       }
-      return ret;
+      // XLDA and GDA
+      return ok && (status & 0x03) == 0x03;
     }
     return 0;
   }
@@ -596,10 +1478,160 @@ public:
     return yaw;
   }
 private:
-  LSM6DSOXClass* _imu = nullptr;
+  static constexpr uint8_t LSM6DSOX_FUNC_CFG_ACCESS = 0x01;
+  static constexpr uint8_t LSM6DSOX_FIFO_CTRL1 = 0x07;
+  static constexpr uint8_t LSM6DSOX_FIFO_CTRL2 = 0x08;
+  static constexpr uint8_t LSM6DSOX_FIFO_CTRL3 = 0x09;
+  static constexpr uint8_t LSM6DSOX_FIFO_CTRL4 = 0x0A;
+  static constexpr uint8_t LSM6DSOX_CTRL1_XL = 0x10;
+  static constexpr uint8_t LSM6DSOX_CTRL2_G = 0x11;
+  static constexpr uint8_t LSM6DSOX_CTRL3_C = 0x12;
+  static constexpr uint8_t LSM6DSOX_CTRL10_C = 0x19;
+  static constexpr uint8_t LSM6DSOX_ALL_INT_SRC = 0x1A;
+  static constexpr uint8_t LSM6DSOX_STATUS_REG = 0x1E;
+  static constexpr uint8_t LSM6DSOX_EMB_FUNC_STATUS_MAINPAGE = 0x35;
+  static constexpr uint8_t LSM6DSOX_OUTX_L_G = 0x22;
+  static constexpr uint8_t LSM6DSOX_FIFO_STATUS1 = 0x3A;
+  static constexpr uint8_t LSM6DSOX_TAP_CFG0 = 0x56;
+  static constexpr uint8_t LSM6DSOX_TAP_CFG1 = 0x57;
+  static constexpr uint8_t LSM6DSOX_TAP_CFG2 = 0x58;
+  static constexpr uint8_t LSM6DSOX_TAP_THS_6D = 0x59;
+  static constexpr uint8_t LSM6DSOX_INT_DUR2 = 0x5A;
+  static constexpr uint8_t LSM6DSOX_WAKE_UP_THS = 0x5B;
+  static constexpr uint8_t LSM6DSOX_WAKE_UP_DUR = 0x5C;
+  static constexpr uint8_t LSM6DSOX_FREE_FALL = 0x5D;
+  static constexpr uint8_t LSM6DSOX_MD1_CFG = 0x5E;
+  static constexpr uint8_t LSM6DSOX_FIFO_DATA_OUT_TAG = 0x78;
+  // embedded functions page
+  static constexpr uint8_t LSM6DSOX_EMB_FUNC_EN_A = 0x04;
+  static constexpr uint8_t LSM6DSOX_EMB_FUNC_INT1 = 0x0A;
+  static constexpr uint8_t LSM6DSOX_PAGE_RW = 0x17;
+  static constexpr uint8_t LSM6DSOX_STEP_COUNTER_L = 0x62;
+  static constexpr uint8_t LSM6DSOX_EMB_FUNC_SRC = 0x64;
+  static constexpr uint8_t FIFO_TAG_GYRO = 0x01;
+  static constexpr uint8_t FIFO_TAG_ACCEL = 0x02;
+  static constexpr uint8_t FIFO_TAG_TIMESTAMP = 0x04;
+  static constexpr uint8_t FIFO_BURST_WORDS = 4;  // 28 bytes, fits the smallest Wire buffers
+  // Run a register sequence with the hub port selected, after enabling latched,
+  // clear-on-read event sources and the basic interrupt engine
+  template<typename F> bool configureEvents(F sequence) {
+    if (!initialized) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    // INT_CLR_ON_READ | LIR
+    auto ok = modifyRegister(getAddress(), LSM6DSOX_TAP_CFG0, 0x41, 0x41) &&
+      modifyRegister(getAddress(), LSM6DSOX_TAP_CFG2, 0x80, 0x80) &&
+      sequence();
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    return ok;
+  }
+  // Threshold code for a value in g with LSB = full scale / steps
+  uint8_t eventThreshold(float thresholdG, uint8_t steps, uint8_t minCode, uint8_t maxCode) {
+    float code = thresholdG * steps / (_accelScale * 32768.0) + 0.5;
+    if (code < minCode) {
+      return minCode;
+    }
+    if (code > maxCode) {
+      return maxCode;
+    }
+    return (uint8_t)code;
+  }
+  // Smallest ODR code whose rate is at least odrHz
+  static uint8_t odrCode(uint16_t odrHz) {
+    if (odrHz == 0) {
+      return 0;
+    }
+    static const uint16_t rates[] = { 13, 26, 52, 104, 208, 416, 833, 1666, 3332, 6664 };
+    for (uint8_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+      if (odrHz <= rates[i]) {
+        return i + 1;
+      }
+    }
+    return 10;
+  }
+  bool writeControl(uint8_t reg, uint8_t keepMask, uint8_t odr, uint8_t fs) {
+    if (!initialized) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    uint8_t value = 0;
+    auto ok = readRegisters(getAddress(), reg, &value, 1);
+    ok = ok && writeRegister(getAddress(), reg, (odr << 4) | fs | (value & keepMask));
+    if (ok) {
+      readScales();
+    }
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    return ok;
+  }
+  // Sensitivities from the configured full scales, same convention as LSM6DSOXClass
+  void readScales() {
+    uint8_t ctrl[2];
+    if (!readRegisters(getAddress(), LSM6DSOX_CTRL1_XL, ctrl, 2)) {
+      return;
+    }
+    static const float accelFs[4] = { 2.0, 16.0, 4.0, 8.0 };
+    static const float gyroFs[4] = { 250.0, 500.0, 1000.0, 2000.0 };
+    _accelScale = accelFs[(ctrl[0] >> 2) & 0x03] / 32768.0;
+    _gyroScale = ((ctrl[1] & 0x02) ? 125.0 : gyroFs[(ctrl[1] >> 2) & 0x03]) / 32768.0;
+  }
+  static int16_t toInt16(const uint8_t* buf) {
+    return (int16_t)(buf[0] | (buf[1] << 8));
+  }
+  // Returns true once both an accel and a gyro word have been collected
+  bool decodeFifoWord(const uint8_t* word, Sample& sample) {
+    switch (word[0] >> 3) {
+      case FIFO_TAG_TIMESTAMP:
+        _fifoTimestamp = (word[1] | (word[2] << 8) | ((uint32_t)word[3] << 16) | ((uint32_t)word[4] << 24)) * 25UL;
+        return false;
+      case FIFO_TAG_ACCEL:
+        _fifoAccel[0] = toInt16(&word[1]);
+        _fifoAccel[1] = toInt16(&word[3]);
+        _fifoAccel[2] = toInt16(&word[5]);
+        _fifoPending |= 0x01;
+        break;
+      case FIFO_TAG_GYRO:
+        _fifoGyro[0] = toInt16(&word[1]);
+        _fifoGyro[1] = toInt16(&word[3]);
+        _fifoGyro[2] = toInt16(&word[5]);
+        _fifoPending |= 0x02;
+        break;
+      default:
+        return false;
+    }
+    if (_fifoPending != 0x03) {
+      return false;
+    }
+    _fifoPending = 0;
+    sample.timestamp = _fifoTimestamp;
+    sample.x = _fifoAccel[0] * _accelScale;
+    sample.y = _fifoAccel[1] * _accelScale;
+    sample.z = _fifoAccel[2] * _accelScale;
+    sample.roll = _fifoGyro[0] * _gyroScale;
+    sample.pitch = _fifoGyro[1] * _gyroScale;
+    sample.yaw = _fifoGyro[2] * _gyroScale;
+    return true;
+  }
+  _driver_storage<LSM6DSOXClass> _imu;
   float x,y,z;
   float roll,pitch,yaw; //gx, gy, gz
   int initialized = 0;
+  float _accelScale = 4.0 / 32768.0;
+  float _gyroScale = 2000.0 / 32768.0;
+  int16_t _fifoAccel[3];
+  int16_t _fifoGyro[3];
+  uint8_t _fifoPending = 0;
+  uint32_t _fifoTimestamp = 0;
+  bool _fifoOverrun = false;
+  bool _pedometer = false;
 };
 
 class ModulinoThermo: public Module {
@@ -610,8 +1642,8 @@ public:
     if (hubPort != nullptr) {
       hubPort->select();
     }
-    if (_sensor == nullptr) {
-      _sensor = new HS300xClass(*((TwoWire*)getWire()));
+    if (!_sensor) {
+      _sensor.emplace(*((TwoWire*)getWire()));
     }
     initialized = _sensor->begin();
     __increaseI2CPriority();
@@ -623,47 +1655,146 @@ public:
   operator bool() {
     return (initialized != 0);
   }
-  float getHumidity() {
-    if (initialized) {
-      if (hubPort != nullptr) {
-        hubPort->select();
-      }
-      auto ret = _sensor->readHumidity();
-      if (hubPort != nullptr) {
-        hubPort->clear();
-      }
-      return ret;
+  // Start a conversion and return immediately, the result is collected by poll()
+  bool startMeasurement() {
+    if (!initialized) {
+      return false;
     }
-    return 0;
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    auto ok = trigger();
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    _pending = ok;
+    _ready = false;
+    _startMs = millis();
+    return ok;
   }
-  float getTemperature() {
+  // Collect the result once the conversion time has elapsed; the bus is not
+  // touched before that. Returns true when a new result was just collected
+  bool poll() {
+    if (!_pending) {
+      return false;
+    }
+    auto elapsed = millis() - _startMs;
+    if (elapsed < HS300X_CONVERSION_MS) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    auto ok = fetch();
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    if (ok) {
+      _pending = false;
+      _ready = true;
+    } else if (!_stale || elapsed > HS300X_TIMEOUT_MS) {
+      _pending = false;
+    }
+    return ok;
+  }
+  // True once the last started measurement has completed
+  bool ready() const {
+    return _ready;
+  }
+  // Blocking measurement: decode temperature and humidity from the same result
+  bool update() {
+    if (!startMeasurement()) {
+      return false;
+    }
+    delay(HS300X_CONVERSION_MS);
+    while (!poll()) {
+      if (!_pending) {
+        return false;
+      }
+      delay(1);
+    }
+    return true;
+  }
+  // Getters return the values of the last completed measurement; once a value has
+  // been returned, the next call to the same getter starts a new measurement
+  float getHumidity() {
     if (initialized) {
-      if (hubPort != nullptr) {
-        hubPort->select();
+      if (!_freshHumidity) {
+        update();
       }
-      auto ret = _sensor->readTemperature();
-      if (hubPort != nullptr) {
-        hubPort->clear();
+      _freshHumidity = false;
+      return _humidity;
+    }
+    return 0;
+  }
+  float getTemperature() {
+    if (initialized) {
+      if (!_freshTemperature) {
+        update();
       }
-      return ret;
+      _freshTemperature = false;
+      return _temperature;
     }
     return 0;
   }
 private:
-  HS300xClass* _sensor = nullptr;
+  static constexpr uint8_t HS300X_ADDRESS = 0x44;
+  static constexpr unsigned long HS300X_CONVERSION_MS = 35;  // 14 bit humidity + temperature
+  static constexpr unsigned long HS300X_TIMEOUT_MS = 100;
+  bool trigger() {
+    getWire()->beginTransmission(HS300X_ADDRESS);
+    return getWire()->endTransmission() == 0;
+  }
+  bool fetch() {
+    uint8_t buf[4];
+    _stale = false;
+    if (getWire()->requestFrom(HS300X_ADDRESS, (uint8_t)4) != 4) {
+      return false;
+    }
+    for (int i = 0; i < 4; i++) {
+      buf[i] = getWire()->read();
+    }
+    // status bits 01: data already read, conversion still in progress
+    if ((buf[0] >> 6) != 0) {
+      _stale = true;
+      return false;
+    }
+    uint16_t rawHumidity = ((buf[0] & 0x3F) << 8) | buf[1];
+    uint16_t rawTemperature = ((buf[2] << 8) | buf[3]) >> 2;
+    _humidity = rawHumidity * (100.0f / 16383.0f);
+    _temperature = rawTemperature * (165.0f / 16383.0f) - 40.0f;
+    _freshHumidity = true;
+    _freshTemperature = true;
+    return true;
+  }
+  _driver_storage<HS300xClass> _sensor;
   int initialized = 0;
+  float _temperature = 0;
+  float _humidity = 0;
+  bool _freshTemperature = false;
+  bool _freshHumidity = false;
+  bool _stale = false;
+  bool _pending = false;
+  bool _ready = false;
+  unsigned long _startMs = 0;
 };
 
 class ModulinoPressure : public Module {
 public:
+  // One record drained from the FIFO in continuous mode
+  struct Sample {
+    uint32_t timestamp;  // microseconds, reconstructed from the read time and the output data rate
+    float pressure;      // kPa
+    float temperature;   // Celsius
+  };
   ModulinoPressure(ModulinoHubPort* hubPort = nullptr)
     : Module(0xFF, "PRESSURE", hubPort) {}
   bool begin() {
     if (hubPort != nullptr) {
       hubPort->select();
     }
-    if (_barometer == nullptr) {
-      _barometer = new LPS22HBClass(*((TwoWire*)getWire()));
+    if (!_barometer) {
+      _barometer.emplace(*((TwoWire*)getWire()));
     }
     initialized = _barometer->begin();
     if (initialized == 0) {
@@ -679,47 +1810,335 @@ public:
   operator bool() {
     return (initialized != 0);
   }
+  // Start a one-shot conversion and return immediately, the result is collected by poll()
+  bool startMeasurement() {
+    if (!initialized || _continuous) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    // ONE_SHOT, keep register auto-increment for the result burst
+    auto ok = writeRegister(LPS22HB_ADDRESS, LPS22HB_CTRL_REG2, 0x11);
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    _pending = ok;
+    _ready = false;
+    _startMs = millis();
+    return ok;
+  }
+  // Collect the result once the conversion time has elapsed; the bus is not
+  // touched before that. Returns true when a new result was just collected
+  bool poll() {
+    if (!_pending) {
+      return false;
+    }
+    auto elapsed = millis() - _startMs;
+    if (elapsed < LPS22HB_CONVERSION_MS) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    // STATUS followed by pressure and temperature in one burst
+    uint8_t buf[6];
+    auto ok = readRegisters(LPS22HB_ADDRESS, LPS22HB_STATUS, buf, 6) && (buf[0] & 0x03) == 0x03;
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    if (ok) {
+      decode(&buf[1], &_pressure, &_temperature);
+      _freshPressure = true;
+      _freshTemperature = true;
+      _pending = false;
+      _ready = true;
+    } else if (elapsed > LPS22HB_TIMEOUT_MS) {
+      _pending = false;
+    }
+    return ok;
+  }
+  // True once the last started measurement has completed
+  bool ready() const {
+    return _ready;
+  }
+  // Blocking measurement of pressure and temperature; in continuous mode the
+  // FIFO is drained and the newest record is kept
+  bool update() {
+    if (_continuous) {
+      Sample sample[FIFO_BURST_SAMPLES];
+      int n;
+      bool ok = false;
+      while ((n = readSeries(sample, FIFO_BURST_SAMPLES)) > 0) {
+        _pressure = sample[n - 1].pressure;
+        _temperature = sample[n - 1].temperature;
+        ok = true;
+      }
+      if (ok) {
+        _freshPressure = true;
+        _freshTemperature = true;
+      }
+      return ok;
+    }
+    if (!startMeasurement()) {
+      return false;
+    }
+    delay(LPS22HB_CONVERSION_MS);
+    while (!poll()) {
+      if (!_pending) {
+        return false;
+      }
+      delay(1);
+    }
+    return true;
+  }
+  // Getters return the values of the last completed measurement; once a value has
+  // been returned, the next call to the same getter starts a new measurement
   float getPressure() {
     if (initialized) {
-      if (hubPort != nullptr) {
-        hubPort->select();
-      }
-      auto ret = _barometer->readPressure();
-      if (hubPort != nullptr) {
-        hubPort->clear();
+      if (!_freshPressure) {
+        update();
       }
-      return ret;
+      _freshPressure = false;
+      return _pressure;
     }
     return 0;
   }
   float getTemperature() {
     if (initialized) {
-      if (hubPort != nullptr) {
-        hubPort->select();
+      if (!_freshTemperature) {
+        update();
       }
-      auto ret = _barometer->readTemperature();
-      if (hubPort != nullptr) {
-        hubPort->clear();
-      }
-      return ret;
+      _freshTemperature = false;
+      return _temperature;
     }
     return 0;
   }
+  // Sample continuously into the FIFO. Output data rate in Hz (rounded up to
+  // 1, 10, 25, 50 or 75), optional low-pass filter with a bandwidth of ODR/9
+  // or ODR/20 (0 leaves it off)
+  bool beginContinuous(uint8_t odrHz = 25, uint8_t lowPassDivider = 0) {
+    if (!initialized) {
+      return false;
+    }
+    uint8_t ctrl1 = 0x02;  // BDU
+    if (odrHz <= 1) {
+      ctrl1 |= 0x10;
+      _periodUs = 1000000UL;
+    } else if (odrHz <= 10) {
+      ctrl1 |= 0x20;
+      _periodUs = 100000UL;
+    } else if (odrHz <= 25) {
+      ctrl1 |= 0x30;
+      _periodUs = 40000UL;
+    } else if (odrHz <= 50) {
+      ctrl1 |= 0x40;
+      _periodUs = 20000UL;
+    } else {
+      ctrl1 |= 0x50;
+      _periodUs = 13333UL;
+    }
+    if (lowPassDivider == 9) {
+      ctrl1 |= 0x08;
+    } else if (lowPassDivider == 20) {
+      ctrl1 |= 0x0C;
+    } else if (lowPassDivider != 0) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    // restart from an empty FIFO: bypass, then stream mode
+    auto ok = writeRegister(LPS22HB_ADDRESS, LPS22HB_CTRL_REG1, 0x00) &&
+      writeRegister(LPS22HB_ADDRESS, LPS22HB_FIFO_CTRL, 0x00) &&
+      writeRegister(LPS22HB_ADDRESS, LPS22HB_CTRL_REG2, 0x50) &&  // FIFO_EN | IF_ADD_INC
+      writeRegister(LPS22HB_ADDRESS, LPS22HB_FIFO_CTRL, 0x40) &&
+      writeRegister(LPS22HB_ADDRESS, LPS22HB_CTRL_REG1, ctrl1);
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    _continuous = ok;
+    _pending = false;
+    return ok;
+  }
+  // Stop continuous sampling and return to one-shot measurements
+  bool endContinuous() {
+    if (!initialized) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    auto ok = writeRegister(LPS22HB_ADDRESS, LPS22HB_CTRL_REG1, 0x00) &&
+      writeRegister(LPS22HB_ADDRESS, LPS22HB_FIFO_CTRL, 0x00) &&
+      writeRegister(LPS22HB_ADDRESS, LPS22HB_CTRL_REG2, 0x10);
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    _continuous = false;
+    return ok;
+  }
+  // Number of records waiting in the FIFO
+  int available() {
+    uint8_t status = 0;
+    if (!fifoStatus(&status)) {
+      return 0;
+    }
+    return status & 0x3F;
+  }
+  // True if records were lost because the FIFO was full since the last call
+  bool fifoOverrun() {
+    uint8_t status = 0;
+    fifoStatus(&status);
+    auto ret = _overrun || (status & 0x40);
+    _overrun = false;
+    return ret;
+  }
+  // Drain up to maxSamples records, oldest first. Returns the number of records read
+  int readSeries(Sample* samples, int maxSamples) {
+    uint8_t status = 0;
+    if (!fifoStatus(&status)) {
+      return 0;
+    }
+    _overrun = _overrun || (status & 0x40);
+    int count = status & 0x3F;
+    if (count > maxSamples) {
+      count = maxSamples;
+    }
+    // the newest record was sampled within the last output period
+    const uint32_t now = micros();
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    int done = 0;
+    while (done < count) {
+      uint8_t buf[FIFO_BURST_SAMPLES * 5];
+      int n = count - done;
+      if (n > FIFO_BURST_SAMPLES) {
+        n = FIFO_BURST_SAMPLES;
+      }
+      // the address wraps from TEMP_OUT_H back to PRESS_OUT_XL, so one
+      // burst pops several records
+      if (!readRegisters(LPS22HB_ADDRESS, LPS22HB_PRESS_OUT_XL, buf, n * 5)) {
+        break;
+      }
+      for (int i = 0; i < n; i++) {
+        Sample& sample = samples[done + i];
+        decode(&buf[i * 5], &sample.pressure, &sample.temperature);
+        sample.timestamp = now - (uint32_t)(count - 1 - done - i) * _periodUs;
+      }
+      done += n;
+    }
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    return done;
+  }
+  // Reference pressure at altitude 0 in kPa, sea level by default
+  void setReferencePressure(float kPa) {
+    if (kPa > 0) {
+      _reference = kPa;
+      _referenceInv = 1.0f / kPa;
+    }
+  }
+  float getReferencePressure() const {
+    return _reference;
+  }
+  // Derive the reference pressure from a known altitude in meters and the last pressure
+  void setReferenceAltitude(float meters) {
+    if (_pressure > 0) {
+      setReferencePressure(_pressure / powf(1.0f - meters / 44330.0f, 5.255f));
+    }
+  }
+  // Altitude in meters of a pressure in kPa, relative to the reference pressure
+  float pressureToAltitude(float kPa) const {
+    return 44330.0f * (1.0f - powf(kPa * _referenceInv, 1.0f / 5.255f));
+  }
+  // Altitude in meters of the last measurement
+  float getAltitude() const {
+    return pressureToAltitude(_pressure);
+  }
 private:
-  LPS22HBClass* _barometer = nullptr;
+  static constexpr uint8_t LPS22HB_ADDRESS = 0x5C;
+  static constexpr uint8_t LPS22HB_CTRL_REG1 = 0x10;
+  static constexpr uint8_t LPS22HB_CTRL_REG2 = 0x11;
+  static constexpr uint8_t LPS22HB_FIFO_CTRL = 0x14;
+  static constexpr uint8_t LPS22HB_FIFO_STATUS = 0x26;
+  static constexpr uint8_t LPS22HB_STATUS = 0x27;
+  static constexpr uint8_t LPS22HB_PRESS_OUT_XL = 0x28;
+  static constexpr int FIFO_BURST_SAMPLES = 5;  // 25 bytes, fits the smallest Wire buffers
+  static constexpr unsigned long LPS22HB_CONVERSION_MS = 14;  // one-shot fits in the 75 Hz output period
+  static constexpr unsigned long LPS22HB_TIMEOUT_MS = 100;
+  bool fifoStatus(uint8_t* status) {
+    if (!initialized || !_continuous) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    auto ok = readRegisters(LPS22HB_ADDRESS, LPS22HB_FIFO_STATUS, status, 1);
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    return ok;
+  }
+  // 24 bit pressure (1/4096 hPa) followed by 16 bit temperature (1/100 C)
+  static void decode(const uint8_t* buf, float* pressure, float* temperature) {
+    int32_t rawPressure = ((int32_t)(int8_t)buf[2] << 16) | ((uint32_t)buf[1] << 8) | buf[0];
+    int16_t rawTemperature = (int16_t)((buf[4] << 8) | buf[3]);
+    *pressure = rawPressure / 40960.0f;
+    *temperature = rawTemperature / 100.0f;
+  }
+  _driver_storage<LPS22HBClass> _barometer;
   int initialized = 0;
+  float _pressure = 0;
+  float _temperature = 0;
+  bool _freshPressure = false;
+  bool _freshTemperature = false;
+  bool _pending = false;
+  bool _ready = false;
+  unsigned long _startMs = 0;
+  bool _continuous = false;
+  bool _overrun = false;
+  uint32_t _periodUs = 0;
+  float _reference = 101.325f;
+  float _referenceInv = 1.0f / 101.325f;
 };
 
 class ModulinoLight : public Module {
 public:
+  // Base color of a classification: twelve 30 degree hue buckets, then the achromatic ones
+  enum ColorBase : uint8_t {
+    COLOR_RED, COLOR_ORANGE, COLOR_YELLOW, COLOR_LIME, COLOR_GREEN, COLOR_SPRING_GREEN,
+    COLOR_CYAN, COLOR_AZURE, COLOR_BLUE, COLOR_VIOLET, COLOR_MAGENTA, COLOR_ROSE,
+    COLOR_WHITE, COLOR_BLACK, COLOR_DARK_GRAY, COLOR_LIGHT_GRAY
+  };
+  enum Lightness : uint8_t {
+    LIGHTNESS_NORMAL, LIGHTNESS_VERY_DARK, LIGHTNESS_DARK, LIGHTNESS_LIGHT, LIGHTNESS_VERY_LIGHT
+  };
+  enum Saturation : uint8_t {
+    SATURATION_NORMAL, SATURATION_VERY_PALE, SATURATION_PALE, SATURATION_VIVID, SATURATION_VERY_VIVID
+  };
+  struct ColorClass {
+    ColorBase base;
+    Lightness lightness;
+    Saturation saturation;
+  };
+  // Longest name is "VERY VIVID VERY LIGHT SPRING GREEN"
+  static constexpr size_t COLOR_NAME_LENGTH = 35;
+  // Channel selection for setChannels()
+  static constexpr uint8_t CHANNEL_COLOR = 0x01;
+  static constexpr uint8_t CHANNEL_LUX = 0x02;
+  static constexpr uint8_t CHANNEL_IR = 0x04;
+  static constexpr uint8_t CHANNEL_ALL = 0x07;
   ModulinoLight(ModulinoHubPort* hubPort = nullptr)
     : Module(0xFF, "LIGHT", hubPort) {}
   bool begin() {
     if (hubPort != nullptr) {
       hubPort->select();
     }
-    if (_light == nullptr) {
-      _light = new LTR381RGBClass(*((TwoWire*)getWire()), 0x53);
+    if (!_light) {
+      _light.emplace(*((TwoWire*)getWire()), 0x53);
     }
     initialized = _light->begin();
     __increaseI2CPriority();
@@ -735,6 +2154,9 @@ public:
     if (!initialized) {
       return false;
     }
+    if (_channels != CHANNEL_ALL || _autoRange) {
+      return updateChannels();
+    }
     if (hubPort != nullptr) {
       hubPort->select();
     }
@@ -744,80 +2166,156 @@ public:
     } 
     return ret == 1;
   }
+  // Restrict update() to some of CHANNEL_COLOR, CHANNEL_LUX and CHANNEL_IR;
+  // the selected channels are read straight from the sensor in one burst
+  bool setChannels(uint8_t channels) {
+    if ((channels & CHANNEL_ALL) == 0) {
+      return false;
+    }
+    _channels = channels & CHANNEL_ALL;
+    return true;
+  }
+  uint8_t getChannels() const {
+    return _channels;
+  }
+  // Analog gain: 1, 3, 6, 9 or 18
+  bool setGain(uint8_t gain) {
+    for (uint8_t i = 0; i < LTR381_GAIN_STEPS; i++) {
+      if (gainValue(i) == gain) {
+        return applyRange(i, _timeIndex);
+      }
+    }
+    return false;
+  }
+  uint8_t getGain() const {
+    return gainValue(_gainIndex);
+  }
+  // Integration time in ms: 25, 50, 100, 200 or 400. With auto ranging this
+  // is the shortest time used
+  bool setIntegrationTime(uint16_t ms) {
+    for (uint8_t i = 0; i < 5; i++) {
+      if ((25U << i) == ms) {
+        _baseTimeIndex = i;
+        return applyRange(_gainIndex, i);
+      }
+    }
+    return false;
+  }
+  uint16_t getIntegrationTime() const {
+    return 25U << _timeIndex;
+  }
+  // Adapt gain and integration time after every reading
+  void setAutoRange(bool enable) {
+    _autoRange = enable;
+  }
+  bool getAutoRange() const {
+    return _autoRange;
+  }
   ModulinoColor getColor() {
     return ModulinoColor(r, g, b);
   }
+  // Approximate color name, e.g. "PALE DARK ORANGE"
   String getColorApproximate() {
-    String color = "UNKNOWN";
-    float h, s, l;
-    _light->getHSL(r, g, b, h, s, l);
+    char name[COLOR_NAME_LENGTH];
+    formatColor(classifyColor(), name, sizeof(name));
+    return String(name);
+  }
+  // Same as above, formatted into a caller buffer without heap allocation.
+  // Returns the length of the full name, like snprintf()
+  size_t getColorApproximate(char* buffer, size_t size) {
+    return formatColor(classifyColor(), buffer, size);
+  }
+  // Classify the last reading into a hue bucket plus lightness and saturation modifiers
+  ColorClass classifyColor() const {
+    return classifyColor(r, g, b);
+  }
+  // Integer only HSL classification of 0-255 components. Every threshold is
+  // compared as an exact fraction, so no float math or rounding is involved
+  static ColorClass classifyColor(int red, int green, int blue) {
+    ColorClass color = {COLOR_WHITE, LIGHTNESS_NORMAL, SATURATION_NORMAL};
+    int32_t hi = red > green ? (red > blue ? red : blue) : (green > blue ? green : blue);
+    int32_t lo = red < green ? (red < blue ? red : blue) : (green < blue ? green : blue);
+    // lightness = sum / 510, saturation = delta / range
+    int32_t sum = hi + lo;
+    int32_t delta = hi - lo;
+    int32_t range = sum <= 255 ? sum : 510 - sum;
 
-    if (l > 90.0) {
-        return "WHITE";
+    if (sum * 100 > 90 * 510) {
+      return color;
     }
-    if (l <= 0.20) {
-        return "BLACK";
+    if (sum * 500 <= 510) {
+      color.base = COLOR_BLACK;
+      return color;
     }
-    if (s < 10.0) {
-        if (l < 50.0) {
-            return "DARK GRAY";
-        } else {
-            return "LIGHT GRAY";
-        }
+    if (delta * 100 < 10 * range) {
+      color.base = sum * 100 < 50 * 510 ? COLOR_DARK_GRAY : COLOR_LIGHT_GRAY;
+      return color;
     }
 
-    if (h < 0) {
-        h = 360 + h;
-    }
-    if (h < 15 || h >= 345) {
-        color = "RED";
-    } else if (h < 45) {
-        color = "ORANGE";
-    } else if (h < 75) {
-        color = "YELLOW";
-    } else if (h < 105) {
-        color = "LIME";
-    } else if (h < 135) {
-        color = "GREEN";
-    } else if (h < 165) {
-        color = "SPRING GREEN";
-    } else if (h < 195) {
-        color = "CYAN";
-    } else if (h < 225) {
-        color = "AZURE";
-    } else if (h < 255) {
-        color = "BLUE";
-    } else if (h < 285) {
-        color = "VIOLET";
-    } else if (h < 315) {
-        color = "MAGENTA";
+    // hue in tenths of a degree, 0..3599
+    int32_t hue;
+    if (hi == red) {
+      hue = (600 * (green - blue) + (green < blue ? 3600 : 0) * delta) / delta;
+    } else if (hi == green) {
+      hue = (600 * (blue - red) + 1200 * delta) / delta;
     } else {
-        color = "ROSE";
+      hue = (600 * (red - green) + 2400 * delta) / delta;
     }
+    // 30 degree buckets centered on red at 0
+    color.base = static_cast<ColorBase>(((hue + 150) / 300) % 12);
 
-    // Adjust color based on lightness
-    if (l < 20.0) {
-        color = "VERY DARK " + color;
-    } else if (l < 40.0) {
-        color = "DARK " + color;
-    } else if (l > 80.0) {
-        color = "VERY LIGHT " + color;
-    } else if (l > 60.0) {
-        color = "LIGHT " + color;
+    if (sum * 100 < 20 * 510) {
+      color.lightness = LIGHTNESS_VERY_DARK;
+    } else if (sum * 100 < 40 * 510) {
+      color.lightness = LIGHTNESS_DARK;
+    } else if (sum * 100 > 80 * 510) {
+      color.lightness = LIGHTNESS_VERY_LIGHT;
+    } else if (sum * 100 > 60 * 510) {
+      color.lightness = LIGHTNESS_LIGHT;
     }
 
-    // Adjust color based on saturation
-    if (s < 20.0) {
-        color = "VERY PALE " + color;
-    } else if (s < 40.0) {
-        color = "PALE " + color;
-    } else if (s > 80.0) {
-        color = "VERY VIVID " + color;
-    } else if (s > 60.0) {
-        color = "VIVID " + color;
+    if (delta * 100 < 20 * range) {
+      color.saturation = SATURATION_VERY_PALE;
+    } else if (delta * 100 < 40 * range) {
+      color.saturation = SATURATION_PALE;
+    } else if (delta * 100 > 80 * range) {
+      color.saturation = SATURATION_VERY_VIVID;
+    } else if (delta * 100 > 60 * range) {
+      color.saturation = SATURATION_VIVID;
     }
     return color;
   }
+  static const char* colorName(ColorBase base) {
+    static const char* const names[] = {
+      "RED", "ORANGE", "YELLOW", "LIME", "GREEN", "SPRING GREEN",
+      "CYAN", "AZURE", "BLUE", "VIOLET", "MAGENTA", "ROSE",
+      "WHITE", "BLACK", "DARK GRAY", "LIGHT GRAY"
+    };
+    return base <= COLOR_LIGHT_GRAY ? names[base] : "UNKNOWN";
+  }
+  // Write "<saturation> <lightness> <color>" into buffer, always terminated.
+  // Returns the length of the full name, like snprintf()
+  static size_t formatColor(const ColorClass& color, char* buffer, size_t size) {
+    static const char* const saturation[] = {"", "VERY PALE ", "PALE ", "VIVID ", "VERY VIVID "};
+    static const char* const lightness[] = {"", "VERY DARK ", "DARK ", "LIGHT ", "VERY LIGHT "};
+    const char* parts[] = {
+      color.saturation <= SATURATION_VERY_VIVID ? saturation[color.saturation] : "",
+      color.lightness <= LIGHTNESS_VERY_LIGHT ? lightness[color.lightness] : "",
+      colorName(color.base)
+    };
+    size_t length = 0;
+    for (const char* part : parts) {
+      for (; *part != '\0'; part++, length++) {
+        if (buffer != nullptr && length + 1 < size) {
+          buffer[length] = *part;
+        }
+      }
+    }
+    if (buffer != nullptr && size > 0) {
+      buffer[length < size ? length : size - 1] = '\0';
+    }
+    return length;
+  }
   int getAL() {
     return rawlux;
   }
@@ -828,59 +2326,288 @@ public:
     return ir;
   }
 private:
-  LTR381RGBClass* _light = nullptr;
+  static constexpr uint8_t LTR381_ADDRESS = 0x53;
+  static constexpr uint8_t LTR381_MEAS_RATE = 0x04;
+  static constexpr uint8_t LTR381_GAIN = 0x05;
+  static constexpr uint8_t LTR381_MAIN_STATUS = 0x07;
+  static constexpr uint8_t LTR381_DATA_IR = 0x0A;
+  static constexpr uint8_t LTR381_DATA_GREEN = 0x0D;
+  static constexpr uint8_t LTR381_DATA_BLUE = 0x13;
+  static constexpr uint8_t LTR381_GAIN_STEPS = 5;
+  static uint8_t gainValue(uint8_t index) {
+    static const uint8_t gains[LTR381_GAIN_STEPS] = {1, 3, 6, 9, 18};
+    return gains[index];
+  }
+  // Read the selected channels, IR, green, red and blue are contiguous
+  bool updateChannels() {
+    if (!_configured && !applyRange(_gainIndex, _timeIndex)) {
+      return false;
+    }
+    const uint8_t first = (_channels & CHANNEL_IR) ? LTR381_DATA_IR : LTR381_DATA_GREEN;
+    const uint8_t last = (_channels & CHANNEL_COLOR) ? LTR381_DATA_BLUE : ((_channels & CHANNEL_LUX) ? LTR381_DATA_GREEN : LTR381_DATA_IR);
+    uint8_t buf[12];
+    uint8_t status = 0;
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    // ALS/CS data status, cleared by the read
+    auto ok = readRegisters(LTR381_ADDRESS, LTR381_MAIN_STATUS, &status, 1) && (status & 0x08) &&
+      readRegisters(LTR381_ADDRESS, first, buf, last - first + 3);
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    if (!ok) {
+      return false;
+    }
+    // the first conversion after a range change may still use the old settings
+    if (_discard > 0) {
+      _discard--;
+      return false;
+    }
+    uint32_t raw[4] = {0, 0, 0, 0};  // IR, green, red, blue
+    for (uint8_t reg = first; reg <= last; reg += 3) {
+      const uint8_t* p = &buf[reg - first];
+      raw[(reg - LTR381_DATA_IR) / 3] = ((uint32_t)(p[2] & 0x0F) << 16) | ((uint32_t)p[1] << 8) | p[0];
+    }
+    const uint32_t full = (1UL << (16 + _timeIndex)) - 1;
+    uint32_t peak = 0;
+    if (_channels & CHANNEL_IR) {
+      ir = raw[0];
+      peak = raw[0];
+    }
+    if (_channels & (CHANNEL_LUX | CHANNEL_COLOR)) {
+      rawlux = raw[1];
+      // datasheet ALS formula, green channel scaled by gain and integration time
+      lux = (int)(0.8f * raw[1] * 4 / (gainValue(_gainIndex) * (1U << _timeIndex)));
+      peak = raw[1] > peak ? raw[1] : peak;
+    }
+    if (_channels & CHANNEL_COLOR) {
+      r = raw[2] * 255 / full;
+      g = raw[1] * 255 / full;
+      b = raw[3] * 255 / full;
+      peak = raw[2] > peak ? raw[2] : peak;
+      peak = raw[3] > peak ? raw[3] : peak;
+    }
+    if (_autoRange) {
+      autoRange(peak, full);
+    }
+    return true;
+  }
+  // Pick the gain that brings the brightest channel close to half scale in one
+  // step; integration time grows only when the highest gain is not enough
+  void autoRange(uint32_t peak, uint32_t full) {
+    uint8_t gainIndex = _gainIndex;
+    uint8_t timeIndex = _timeIndex;
+    if (peak >= full - full / 20) {
+      // saturated, the real level is unknown
+      gainIndex = gainIndex >= 2 ? gainIndex - 2 : 0;
+    } else {
+      const uint32_t current = gainValue(_gainIndex);
+      gainIndex = 0;
+      for (uint8_t i = LTR381_GAIN_STEPS - 1; i > 0; i--) {
+        if ((uint64_t)peak * gainValue(i) / current <= full / 2) {
+          gainIndex = i;
+          break;
+        }
+      }
+      const uint32_t projected = (uint64_t)peak * gainValue(gainIndex) / current;
+      if (projected < full / 32 && timeIndex < 4) {
+        timeIndex++;
+      } else if (projected >= full / 8 && timeIndex > _baseTimeIndex) {
+        timeIndex--;
+      }
+    }
+    if (gainIndex != _gainIndex || timeIndex != _timeIndex) {
+      applyRange(gainIndex, timeIndex);
+    }
+  }
+  bool applyRange(uint8_t gainIndex, uint8_t timeIndex) {
+    if (!initialized) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    // resolution 20 bit at 400 ms down to 16 bit at 25 ms, measurement rate
+    // codes 25, 50, 100, 200 and 500 ms
+    auto ok = writeRegister(LTR381_ADDRESS, LTR381_GAIN, gainIndex) &&
+      writeRegister(LTR381_ADDRESS, LTR381_MEAS_RATE, ((4 - timeIndex) << 4) | timeIndex);
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    if (ok) {
+      _gainIndex = gainIndex;
+      _timeIndex = timeIndex;
+      _configured = true;
+      _discard = 1;
+    }
+    return ok;
+  }
+  _driver_storage<LTR381RGBClass> _light;
   int r, g, b, rawlux, lux, ir;
   int initialized = 0;
+  uint8_t _channels = CHANNEL_ALL;
+  bool _autoRange = false;
+  bool _configured = false;
+  uint8_t _discard = 0;
+  uint8_t _gainIndex = 1;       // 3x, sensor default
+  uint8_t _timeIndex = 2;       // 100 ms, sensor default
+  uint8_t _baseTimeIndex = 2;
 };
 
+// Result of either sensor variant
+struct ModulinoDistanceResult {
+  uint8_t range_status;
+  uint16_t distance_mm;
+  uint16_t ambient_rate_kcps;
+  uint16_t ambient_per_spad_kcps;
+  uint16_t signal_rate_kcps;
+  uint16_t signal_per_spad_kcps;
+  uint16_t number_of_spad;
+  uint16_t sigma_mm;
+};
+
+// VL53L4CD or VL53L4ED driver constructed in place, the variant is resolved
+// once in begin() into a table of operations so calls do not branch on it
 class _distance_api {
 public:
-  _distance_api(VL53L4CD* sensor) : sensor(sensor) {
-    isVL53L4CD = true;
-  };
-  _distance_api(VL53L4ED* sensor) : sensor(sensor) {};
-  uint8_t setRangeTiming(uint32_t timing_budget_ms, uint32_t inter_measurement_ms) {
-    if (isVL53L4CD) {
-      return ((VL53L4CD*)sensor)->VL53L4CD_SetRangeTiming(timing_budget_ms, inter_measurement_ms);
-    } else {
-      return ((VL53L4ED*)sensor)->VL53L4ED_SetRangeTiming(timing_budget_ms, inter_measurement_ms);
+  _distance_api() {}
+  ~_distance_api() {
+    end();
+  }
+  bool begin(TwoWire* wire) {
+    end();
+    new (&sensor.cd) VL53L4CD(wire, -1);
+    if (sensor.cd.InitSensor() == VL53L4CD_ERROR_NONE) {
+      ops = &cdOps();
+      return true;
+    }
+    sensor.cd.~VL53L4CD();
+    new (&sensor.ed) VL53L4ED(wire, -1);
+    if (sensor.ed.InitSensor() == VL53L4ED_ERROR_NONE) {
+      ops = &edOps();
+      return true;
     }
+    sensor.ed.~VL53L4ED();
+    return false;
   }
-  uint8_t startRanging() {
-    if (isVL53L4CD) {
-      return ((VL53L4CD*)sensor)->VL53L4CD_StartRanging();
-    } else {
-      return ((VL53L4ED*)sensor)->VL53L4ED_StartRanging();
+  void end() {
+    if (ops != nullptr) {
+      ops->destroy(sensor);
+      ops = nullptr;
     }
   }
+  explicit operator bool() const {
+    return ops != nullptr;
+  }
+  uint8_t setRangeTiming(uint32_t timing_budget_ms, uint32_t inter_measurement_ms) {
+    return ops->setRangeTiming(sensor, timing_budget_ms, inter_measurement_ms);
+  }
+  uint8_t startRanging() {
+    return ops->startRanging(sensor);
+  }
+  uint8_t stopRanging() {
+    return ops->stopRanging(sensor);
+  }
   uint8_t checkForDataReady(uint8_t* p_is_data_ready) {
-    if (isVL53L4CD) {
-      return ((VL53L4CD*)sensor)->VL53L4CD_CheckForDataReady(p_is_data_ready);
-    } else {
-      return ((VL53L4ED*)sensor)->VL53L4ED_CheckForDataReady(p_is_data_ready);
-    }
+    return ops->checkForDataReady(sensor, p_is_data_ready);
+  }
+  uint8_t setDetectionThresholds(uint16_t low_mm, uint16_t high_mm, uint8_t window) {
+    return ops->setDetectionThresholds(sensor, low_mm, high_mm, window);
   }
   uint8_t clearInterrupt() {
-    if (isVL53L4CD) {
-      return ((VL53L4CD*)sensor)->VL53L4CD_ClearInterrupt();
-    } else {
-      return ((VL53L4ED*)sensor)->VL53L4ED_ClearInterrupt();
-    }
+    return ops->clearInterrupt(sensor);
   }
-  uint8_t getResult(void* result) {
-    if (isVL53L4CD) {
-      return ((VL53L4CD*)sensor)->VL53L4CD_GetResult((VL53L4CD_Result_t*)result);
-    } else {
-      return ((VL53L4ED*)sensor)->VL53L4ED_GetResult((VL53L4ED_ResultsData_t*)result);
-    }
+  uint8_t getResult(ModulinoDistanceResult* result) {
+    return ops->getResult(sensor, result);
   }
 private:
-  void* sensor;
-  bool isVL53L4CD = false;
+  union Sensor {
+    Sensor() {}
+    ~Sensor() {}
+    VL53L4CD cd;
+    VL53L4ED ed;
+  };
+  struct Ops {
+    void (*destroy)(Sensor&);
+    uint8_t (*setRangeTiming)(Sensor&, uint32_t, uint32_t);
+    uint8_t (*startRanging)(Sensor&);
+    uint8_t (*stopRanging)(Sensor&);
+    uint8_t (*checkForDataReady)(Sensor&, uint8_t*);
+    uint8_t (*setDetectionThresholds)(Sensor&, uint16_t, uint16_t, uint8_t);
+    uint8_t (*clearInterrupt)(Sensor&);
+    uint8_t (*getResult)(Sensor&, ModulinoDistanceResult*);
+  };
+  template<typename T> static void copyResult(const T& from, ModulinoDistanceResult* to) {
+    to->range_status = from.range_status;
+    to->distance_mm = from.distance_mm;
+    to->ambient_rate_kcps = from.ambient_rate_kcps;
+    to->ambient_per_spad_kcps = from.ambient_per_spad_kcps;
+    to->signal_rate_kcps = from.signal_rate_kcps;
+    to->signal_per_spad_kcps = from.signal_per_spad_kcps;
+    to->number_of_spad = from.number_of_spad;
+    to->sigma_mm = from.sigma_mm;
+  }
+  static void cdDestroy(Sensor& s) { s.cd.~VL53L4CD(); }
+  static uint8_t cdSetRangeTiming(Sensor& s, uint32_t budget, uint32_t inter) { return s.cd.VL53L4CD_SetRangeTiming(budget, inter); }
+  static uint8_t cdStartRanging(Sensor& s) { return s.cd.VL53L4CD_StartRanging(); }
+  static uint8_t cdStopRanging(Sensor& s) { return s.cd.VL53L4CD_StopRanging(); }
+  static uint8_t cdCheckForDataReady(Sensor& s, uint8_t* ready) { return s.cd.VL53L4CD_CheckForDataReady(ready); }
+  static uint8_t cdSetDetectionThresholds(Sensor& s, uint16_t low, uint16_t high, uint8_t window) { return s.cd.VL53L4CD_SetDetectionThresholds(low, high, window); }
+  static uint8_t cdClearInterrupt(Sensor& s) { return s.cd.VL53L4CD_ClearInterrupt(); }
+  static uint8_t cdGetResult(Sensor& s, ModulinoDistanceResult* result) {
+    VL53L4CD_Result_t native;
+    auto ret = s.cd.VL53L4CD_GetResult(&native);
+    copyResult(native, result);
+    return ret;
+  }
+  static void edDestroy(Sensor& s) { s.ed.~VL53L4ED(); }
+  static uint8_t edSetRangeTiming(Sensor& s, uint32_t budget, uint32_t inter) { return s.ed.VL53L4ED_SetRangeTiming(budget, inter); }
+  static uint8_t edStartRanging(Sensor& s) { return s.ed.VL53L4ED_StartRanging(); }
+  static uint8_t edStopRanging(Sensor& s) { return s.ed.VL53L4ED_StopRanging(); }
+  static uint8_t edCheckForDataReady(Sensor& s, uint8_t* ready) { return s.ed.VL53L4ED_CheckForDataReady(ready); }
+  static uint8_t edSetDetectionThresholds(Sensor& s, uint16_t low, uint16_t high, uint8_t window) { return s.ed.VL53L4ED_SetDetectionThresholds(low, high, window); }
+  static uint8_t edClearInterrupt(Sensor& s) { return s.ed.VL53L4ED_ClearInterrupt(); }
+  static uint8_t edGetResult(Sensor& s, ModulinoDistanceResult* result) {
+    VL53L4ED_ResultsData_t native;
+    auto ret = s.ed.VL53L4ED_GetResult(&native);
+    copyResult(native, result);
+    return ret;
+  }
+  static const Ops& cdOps() {
+    static const Ops table = {
+      cdDestroy, cdSetRangeTiming, cdStartRanging, cdStopRanging,
+      cdCheckForDataReady, cdSetDetectionThresholds, cdClearInterrupt, cdGetResult
+    };
+    return table;
+  }
+  static const Ops& edOps() {
+    static const Ops table = {
+      edDestroy, edSetRangeTiming, edStartRanging, edStopRanging,
+      edCheckForDataReady, edSetDetectionThresholds, edClearInterrupt, edGetResult
+    };
+    return table;
+  }
+  Sensor sensor;
+  const Ops* ops = nullptr;
 };
 
 class ModulinoDistance : public Module {
 public:
+  // Timing presets for setRangingMode()
+  enum RangingMode : uint8_t {
+    RANGING_SHORT_LATENCY,  // 10 ms budget, back to back
+    RANGING_BALANCED,       // 20 ms budget, back to back (default)
+    RANGING_LONG_RANGE,     // 200 ms budget, best range and accuracy
+    RANGING_LOW_POWER       // 20 ms budget every 500 ms
+  };
+  // Conditions for setDetection(), evaluated by the sensor
+  enum DetectionWindow : uint8_t {
+    DETECT_BELOW = 0,    // distance < low
+    DETECT_ABOVE = 1,    // distance > high
+    DETECT_OUTSIDE = 2,  // distance < low or > high
+    DETECT_INSIDE = 3    // low <= distance <= high
+  };
   ModulinoDistance(ModulinoHubPort* hubPort = nullptr)
     : Module(0xFF, "DISTANCE", hubPort) {}
   bool begin() {
@@ -889,58 +2616,145 @@ public:
       hubPort->select();
     }
     // try scanning for 0x29 since the library contains a while(true) on begin()
-    getWire()->beginTransmission(0x29);
+    getWire()->beginTransmission(VL53L4_ADDRESS);
     if (getWire()->endTransmission() != 0) {
       if (hubPort != nullptr) {
         hubPort->clear();
       }
       return false;
     }
-    tof_sensor = new VL53L4CD((TwoWire*)getWire(), -1);
-    auto ret = tof_sensor->InitSensor();
-    if (ret != VL53L4CD_ERROR_NONE) {
-      delete tof_sensor;
-      tof_sensor = nullptr;
-      tof_sensor_alt = new VL53L4ED((TwoWire*)getWire(), -1);
-      ret = tof_sensor_alt->InitSensor();
-      if (ret == VL53L4ED_ERROR_NONE) {
-        api = new _distance_api(tof_sensor_alt);
-      } else {
-        delete tof_sensor_alt;
-        tof_sensor_alt = nullptr;
-        if (hubPort != nullptr) {
-          hubPort->clear();
-        }
-        return false;
+    if (!api.begin((TwoWire*)getWire())) {
+      if (hubPort != nullptr) {
+        hubPort->clear();
       }
-    } else {
-      api = new _distance_api(tof_sensor);
+      return false;
     }
 
     __increaseI2CPriority();
-    api->setRangeTiming(20, 0);
-    api->startRanging();
+    api.setRangeTiming(_timingBudgetMs, _interMeasurementMs);
+    api.startRanging();
     if (hubPort != nullptr) {
       hubPort->clear();
     }
+    _dueMs = millis() + periodMs();
     return true;
   }
+  // Timing budget 10..200 ms; inter measurement 0 for back to back ranging,
+  // otherwise longer than the budget. Can be called before begin()
+  bool setRangeTiming(uint32_t timingBudgetMs, uint32_t interMeasurementMs = 0) {
+    if (timingBudgetMs < 10 || timingBudgetMs > 200 ||
+        (interMeasurementMs != 0 && interMeasurementMs <= timingBudgetMs)) {
+      return false;
+    }
+    _timingBudgetMs = timingBudgetMs;
+    _interMeasurementMs = interMeasurementMs;
+    if (!api) {
+      return true;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    auto ret = api.stopRanging();
+    ret |= api.setRangeTiming(_timingBudgetMs, _interMeasurementMs);
+    ret |= api.startRanging();
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    _dueMs = millis() + periodMs();
+    return ret == 0;
+  }
+  bool setRangingMode(RangingMode mode) {
+    switch (mode) {
+      case RANGING_SHORT_LATENCY: return setRangeTiming(10, 0);
+      case RANGING_BALANCED: return setRangeTiming(20, 0);
+      case RANGING_LONG_RANGE: return setRangeTiming(200, 0);
+      case RANGING_LOW_POWER: return setRangeTiming(20, 500);
+    }
+    return false;
+  }
+  // Only report results matching the window; the sensor keeps ranging but
+  // raises its ready flag only when the condition is met, so an idle sensor
+  // costs one status read per measurement period
+  bool setDetection(DetectionWindow window, uint16_t lowMm, uint16_t highMm = 0) {
+    if (!api) {
+      return false;
+    }
+    if (window == DETECT_ABOVE && highMm == 0) {
+      highMm = lowMm;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    auto ret = api.setDetectionThresholds(lowMm, highMm, window);
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    _detection = ret == 0;
+    _detected = false;
+    return _detection;
+  }
+  // Report every result again
+  bool clearDetection() {
+    if (!api) {
+      return false;
+    }
+    if (hubPort != nullptr) {
+      hubPort->select();
+    }
+    // SYSTEM__INTERRUPT back to "new sample ready"
+    getWire()->beginTransmission(VL53L4_ADDRESS);
+    getWire()->write(0x00);
+    getWire()->write(0x46);
+    getWire()->write(0x20);
+    auto ok = getWire()->endTransmission() == 0;
+    if (hubPort != nullptr) {
+      hubPort->clear();
+    }
+    _detection = !ok && _detection;
+    return ok;
+  }
+  // True once per result matching the detection window, get() returns its distance
+  bool detected() {
+    available();
+    auto ret = _detected;
+    _detected = false;
+    return ret;
+  }
+  uint32_t getTimingBudget() const {
+    return _timingBudgetMs;
+  }
+  uint32_t getInterMeasurement() const {
+    return _interMeasurementMs;
+  }
   operator bool() {
-    return (api != nullptr);
+    return (bool)api;
   }
   bool available() {
-    if (api == nullptr) {
+    if (!api) {
       return false;
     }
+    // no readiness poll before the next result is due
+    if (!due()) {
+      return !isnan(internal);
+    }
 
     if (hubPort != nullptr) {
       hubPort->select();
     }
     uint8_t NewDataReady = 0;
-    api->checkForDataReady(&NewDataReady);
+    api.checkForDataReady(&NewDataReady);
     if (NewDataReady) {
-      api->clearInterrupt();
-      api->getResult(&results);
+      api.clearInterrupt();
+      api.getResult(&results);
+      _resultMs = millis();
+      scheduleNext();
+      // a sigma or signal failure is not a detection
+      _detected = results.range_status == 0;
+    } else if (_detection) {
+      // nothing matched this period, wait for the next measurement
+      while ((int32_t)(millis() - _dueMs) >= 0) {
+        _dueMs += periodMs();
+      }
     }
     if (hubPort != nullptr) {
       hubPort->clear();
@@ -955,13 +2769,56 @@ public:
   float get() {
     return internal;
   }
+  // True once the next result may be ready, available() only queries the sensor then
+  bool due() const {
+    return (bool)api && (int32_t)(millis() - (_dueMs - dueMarginMs())) >= 0;
+  }
+  // Details of the last result read by available()
+  uint8_t getRangeStatus() const {
+    return results.range_status;
+  }
+  uint16_t getSigma() const {
+    return results.sigma_mm;
+  }
+  uint16_t getSignalRate() const {
+    return results.signal_rate_kcps;
+  }
+  uint16_t getAmbientRate() const {
+    return results.ambient_rate_kcps;
+  }
+  // millis() when the last result was read
+  uint32_t getTimestamp() const {
+    return _resultMs;
+  }
 private:
-  VL53L4CD* tof_sensor = nullptr;
-  VL53L4ED* tof_sensor_alt = nullptr;
-  VL53L4CD_Result_t results;
-  //VL53L4ED_ResultsData_t results;
+  uint32_t periodMs() const {
+    return _interMeasurementMs != 0 ? _interMeasurementMs : _timingBudgetMs;
+  }
+  // poll slightly early so a sensor clock running fast is not missed
+  uint32_t dueMarginMs() const {
+    return 1 + periodMs() / 16;
+  }
+  // Stay locked to the sensor's own period while results are collected on
+  // time, resynchronize after a late or early collection
+  void scheduleNext() {
+    const uint32_t now = millis();
+    const int32_t late = (int32_t)(now - _dueMs);
+    if (late >= 0 && (uint32_t)late < periodMs()) {
+      _dueMs += periodMs();
+    } else {
+      _dueMs = now + periodMs();
+    }
+  }
+  static constexpr uint8_t VL53L4_ADDRESS = 0x29;
+  bool _detection = false;
+  bool _detected = false;
+  uint32_t _timingBudgetMs = 20;
+  uint32_t _interMeasurementMs = 0;
+  uint32_t _dueMs = 0;
+  uint32_t _resultMs = 0;
+  ModulinoDistanceResult results = {};
   float internal = NAN;
-  _distance_api* api = nullptr;
+  _distance_api api;
 };
 
 class ModulinoOptoRelay : public Module {
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Modulino.h"
+
+/**
+ * @brief Ranges with several Modulino Distance sensors at once.
+ * Sensors sit on different hub ports and range continuously, so their timing
+ * budgets overlap. begin() staggers their start times across one measurement
+ * period, and poll() visits the sensors round-robin, querying only one whose
+ * next result is due per call. The aggregate rate approaches the number of
+ * sensors times the single-sensor rate, with the bus load spread evenly.
+ * @tparam MAX_SENSORS Capacity of the array.
+ */
+template<uint8_t MAX_SENSORS = 8>
+class ModulinoDistanceArray {
+public:
+	/**
+	 * @brief Add a sensor as the next element of the array.
+	 * @param sensor Distance module on its own hub port, begin() is called by the array.
+	 * @return True when the sensor was added.
+	 */
+	bool add(ModulinoDistance& sensor) {
+		if (_count >= MAX_SENSORS) {
+			return false;
+		}
+		_sensors[_count] = &sensor;
+		_timestamp[_count] = 0;
+		_count++;
+		return true;
+	}
+
+	/**
+	 * @brief Get the number of sensors in the array.
+	 */
+	uint8_t sensors() const {
+		return _count;
+	}
+
+	/**
+	 * @brief Start ranging on all sensors with their results spread over one period.
+	 * @param timingBudgetMs Timing budget of every sensor, 10..200 ms.
+	 * @param interMeasurementMs Inter measurement period, 0 for back to back ranging.
+	 * @return Number of sensors found and ranging.
+	 */
+	uint8_t begin(uint32_t timingBudgetMs = 20, uint32_t interMeasurementMs = 0) {
+		const uint32_t periodUs = (interMeasurementMs != 0 ? interMeasurementMs : timingBudgetMs) * 1000UL;
+		uint8_t ready = 0;
+		for (uint8_t i = 0; i < _count; i++) {
+			_sensors[i]->setRangeTiming(timingBudgetMs, interMeasurementMs);
+			if (!*_sensors[i] && !_sensors[i]->begin()) {
+				continue;
+			}
+			ready++;
+		}
+		// restart each sensor a fraction of a period after the previous one
+		uint32_t start = micros();
+		for (uint8_t i = 0; i < _count; i++) {
+			if (!*_sensors[i]) {
+				continue;
+			}
+			while ((uint32_t)(micros() - start) < periodUs / _count * i) {
+			}
+			_sensors[i]->setRangeTiming(timingBudgetMs, interMeasurementMs);
+		}
+		_next = 0;
+		return ready;
+	}
+
+	/**
+	 * @brief Harvest at most one sensor whose result is due, round-robin.
+	 * Call this as often as possible from loop().
+	 * @return Index of the sensor with a new result, -1 if none this call.
+	 */
+	int poll() {
+		for (uint8_t k = 0; k < _count; k++) {
+			const uint8_t i = (_next + k) % _count;
+			ModulinoDistance& sensor = *_sensors[i];
+			if (!sensor.due()) {
+				continue;
+			}
+			_next = (i + 1) % _count;
+			sensor.available();
+			if (sensor.getTimestamp() != _timestamp[i]) {
+				_timestamp[i] = sensor.getTimestamp();
+				return i;
+			}
+			return -1;
+		}
+		return -1;
+	}
+
+	/**
+	 * @brief Get the last distance of a sensor.
+	 * @param index Sensor index in order of add() calls.
+	 * @return Distance in mm, NAN if invalid.
+	 */
+	float get(uint8_t index) const {
+		return index < _count ? _sensors[index]->get() : NAN;
+	}
+
+	/**
+	 * @brief Get the time the last result of a sensor was read.
+	 * @param index Sensor index in order of add() calls.
+	 * @return millis() at the time of the read.
+	 */
+	uint32_t getTimestamp(uint8_t index) const {
+		return index < _count ? _timestamp[index] : 0;
+	}
+
+	/**
+	 * @brief Access a sensor of the array.
+	 * @param index Sensor index in order of add() calls.
+	 */
+	ModulinoDistance& sensor(uint8_t index) {
+		return *_sensors[index];
+	}
+
+private:
+	ModulinoDistance* _sensors[MAX_SENSORS] = {nullptr};
+	uint32_t _timestamp[MAX_SENSORS] = {0};
+	uint8_t _count = 0;
+	uint8_t _next = 0;
+};
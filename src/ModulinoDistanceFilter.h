@@ -0,0 +1,238 @@
+#pragma once
+
+#include "Modulino.h"
+
+/**
+ * @brief Filtered, timestamped distance series for Modulino Distance.
+ * Every result goes through three stages: rejection of invalid or weak readings
+ * using the range status, signal rate and sigma reported by the sensor, a
+ * median over the last accepted readings, and a 1-D Kalman filter whose
+ * measurement noise follows the per-result sigma. Samples are kept in a fixed
+ * ring, so memory use is static and each sample costs constant time.
+ * @tparam RING_LENGTH Number of samples kept in the series.
+ * @tparam MEDIAN_LENGTH Median window, odd values work best.
+ */
+template<uint8_t RING_LENGTH = 16, uint8_t MEDIAN_LENGTH = 5>
+class ModulinoDistanceFilter {
+	static_assert(RING_LENGTH > 0, "RING_LENGTH must be at least 1");
+	static_assert(MEDIAN_LENGTH > 0 && MEDIAN_LENGTH <= 15, "MEDIAN_LENGTH must be 1..15");
+
+public:
+	static constexpr uint8_t MAX_REJECTED = 3;
+
+	struct Sample {
+		uint32_t timestamp;  // millis() when the result was read
+		float raw;           // sensor distance in mm, NAN when invalid
+		float median;        // median of the accepted readings in mm
+		float filtered;      // Kalman estimate in mm
+		uint16_t sigma;      // sensor sigma estimate in mm
+		uint16_t signal;     // signal rate in kcps
+		bool rejected;       // not used for the estimate
+	};
+
+	/**
+	 * @brief Reject results whose signal rate is below a threshold.
+	 * @param kcps Minimum signal rate, 0 disables the check.
+	 */
+	void setSignalThreshold(uint16_t kcps) {
+		_minSignal = kcps;
+	}
+
+	/**
+	 * @brief Reject results whose sigma is above a threshold.
+	 * @param mm Maximum sigma, 0 disables the check.
+	 */
+	void setSigmaThreshold(uint16_t mm) {
+		_maxSigma = mm;
+	}
+
+	/**
+	 * @brief Set how fast the distance is expected to change.
+	 * @param mmPerSqrtS Process noise; higher values follow motion faster, lower smooth more.
+	 */
+	void setProcessNoise(float mmPerSqrtS) {
+		_q = mmPerSqrtS * mmPerSqrtS;
+	}
+
+	/**
+	 * @brief Reject readings further from the estimate than a number of standard deviations.
+	 * After MAX_REJECTED consecutive rejections the filter restarts from the new reading,
+	 * so real jumps are followed.
+	 * @param sigmas Gate width, 0 disables the check.
+	 */
+	void setGate(float sigmas) {
+		_gate2 = sigmas * sigmas;
+	}
+
+	/**
+	 * @brief Clear the series and the filter state.
+	 */
+	void reset() {
+		_count = 0;
+		_head = 0;
+		_medianCount = 0;
+		_medianHead = 0;
+		_started = false;
+		_rejected = 0;
+	}
+
+	/**
+	 * @brief Poll a distance module and process its result if a new one arrived.
+	 * @param distance Initialized distance module.
+	 * @return True when a new sample was added, accepted or not.
+	 */
+	bool update(ModulinoDistance& distance) {
+		distance.available();
+		const uint32_t timestamp = distance.getTimestamp();
+		if (timestamp == _lastTimestamp) {
+			return false;
+		}
+		_lastTimestamp = timestamp;
+		add(timestamp, distance.getRangeStatus() == 0 ? distance.get() : NAN,
+			distance.getSigma(), distance.getSignalRate());
+		return true;
+	}
+
+	/**
+	 * @brief Process one result.
+	 * @param timestamp Read time in milliseconds.
+	 * @param distanceMm Distance in mm, NAN for an invalid result.
+	 * @param sigma Sensor sigma estimate in mm.
+	 * @param signal Signal rate in kcps.
+	 * @return True when the sample was accepted.
+	 */
+	bool add(uint32_t timestamp, float distanceMm, uint16_t sigma, uint16_t signal) {
+		Sample& sample = _ring[_head];
+		_head = (_head + 1) % RING_LENGTH;
+		if (_count < RING_LENGTH) {
+			_count++;
+		}
+		sample.timestamp = timestamp;
+		sample.raw = distanceMm;
+		sample.sigma = sigma;
+		sample.signal = signal;
+		sample.rejected = isnan(distanceMm) ||
+			(_minSignal != 0 && signal < _minSignal) ||
+			(_maxSigma != 0 && sigma > _maxSigma);
+
+		if (!sample.rejected) {
+			_window[_medianHead] = distanceMm;
+			_medianHead = (_medianHead + 1) % MEDIAN_LENGTH;
+			if (_medianCount < MEDIAN_LENGTH) {
+				_medianCount++;
+			}
+			const float z = median();
+			// measurement noise from the sensor's own sigma estimate
+			const float r = sigma > 0 ? (float)sigma * sigma : 1.0f;
+			if (!_started) {
+				restart(z, r, timestamp);
+			} else {
+				const float dt = (timestamp - _timestamp) * 1e-3f;
+				const float p = _p + _q * dt;
+				const float innovation = z - _x;
+				if (_gate2 > 0 && innovation * innovation > _gate2 * (p + r)) {
+					sample.rejected = true;
+					if (++_rejected >= MAX_REJECTED) {
+						restart(z, r, timestamp);
+						sample.rejected = false;
+					}
+				} else {
+					const float k = p / (p + r);
+					_x += k * innovation;
+					_p = (1.0f - k) * p;
+					_timestamp = timestamp;
+					_rejected = 0;
+				}
+			}
+			_median = z;
+		}
+		sample.median = _median;
+		sample.filtered = _started ? _x : NAN;
+		return !sample.rejected;
+	}
+
+	/**
+	 * @brief Get the current Kalman estimate.
+	 * @return Distance in mm, NAN before the first accepted sample.
+	 */
+	float get() const {
+		return _started ? _x : NAN;
+	}
+
+	/**
+	 * @brief Get the median of the last accepted readings.
+	 * @return Distance in mm, NAN before the first accepted sample.
+	 */
+	float getMedian() const {
+		return _medianCount > 0 ? _median : NAN;
+	}
+
+	/**
+	 * @brief Get the standard deviation of the current estimate.
+	 * @return Uncertainty in mm.
+	 */
+	float getUncertainty() const {
+		return _started ? sqrtf(_p) : NAN;
+	}
+
+	/**
+	 * @brief Get the number of samples in the series.
+	 */
+	uint8_t available() const {
+		return _count;
+	}
+
+	/**
+	 * @brief Access the series, 0 is the newest sample.
+	 * @param age Sample index, must be below available().
+	 */
+	const Sample& sample(uint8_t age) const {
+		return _ring[(_head + RING_LENGTH - 1 - age % RING_LENGTH) % RING_LENGTH];
+	}
+
+private:
+	void restart(float z, float r, uint32_t timestamp) {
+		_x = z;
+		_p = r;
+		_timestamp = timestamp;
+		_started = true;
+		_rejected = 0;
+	}
+
+	/**
+	 * @brief Median of the window by insertion sort of a copy, constant for a fixed window.
+	 */
+	float median() const {
+		float sorted[MEDIAN_LENGTH];
+		for (uint8_t i = 0; i < _medianCount; i++) {
+			const float v = _window[i];
+			uint8_t j = i;
+			for (; j > 0 && sorted[j - 1] > v; j--) {
+				sorted[j] = sorted[j - 1];
+			}
+			sorted[j] = v;
+		}
+		return sorted[_medianCount / 2];
+	}
+
+	Sample _ring[RING_LENGTH];
+	uint8_t _head = 0;
+	uint8_t _count = 0;
+
+	float _window[MEDIAN_LENGTH];
+	uint8_t _medianHead = 0;
+	uint8_t _medianCount = 0;
+	float _median = NAN;
+
+	uint16_t _minSignal = 0;
+	uint16_t _maxSigma = 0;
+	float _q = 100.0f;     // (10 mm)^2 per second
+	float _gate2 = 16.0f;  // 4 sigma
+
+	bool _started = false;
+	float _x = 0;
+	float _p = 0;
+	uint32_t _timestamp = 0;
+	uint32_t _lastTimestamp = 0;
+	uint8_t _rejected = 0;
+};
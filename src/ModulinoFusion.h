@@ -0,0 +1,449 @@
+#pragma once
+
+#include "Modulino.h"
+
+/**
+ * @brief Mahony orientation filter for Modulino Movement data, floating-point version.
+ * The proportional term pulls the attitude towards the measured gravity vector, the
+ * integral term converges to the gyroscope bias. Integration uses the real time between
+ * samples taken from their timestamps, so irregular sample rates are handled.
+ */
+class ModulinoFusion {
+public:
+	static constexpr uint32_t MAX_DT_US = 500000;
+
+	/**
+	 * @brief Construct a filter.
+	 * @param kp Proportional gain, higher trusts the accelerometer more.
+	 * @param ki Integral gain used for gyroscope bias estimation, 0 disables it.
+	 */
+	ModulinoFusion(float kp = 1.0f, float ki = 0.02f)
+		: _kp(kp), _ki(ki) {}
+
+	/**
+	 * @brief Set filter gains.
+	 * @param kp Proportional gain.
+	 * @param ki Integral gain, 0 disables bias estimation.
+	 */
+	void setGains(float kp, float ki) {
+		_kp = kp;
+		_ki = ki;
+	}
+
+	/**
+	 * @brief Reset attitude to identity and clear the bias estimate.
+	 */
+	void reset() {
+		_q0 = 1.0f;
+		_q1 = _q2 = _q3 = 0.0f;
+		_biasX = _biasY = _biasZ = 0.0f;
+		_started = false;
+	}
+
+	/**
+	 * @brief Feed one sample.
+	 * The first sample only latches its timestamp. Gaps longer than MAX_DT_US restart timing.
+	 * @param gx Angular rate around X in dps.
+	 * @param gy Angular rate around Y in dps.
+	 * @param gz Angular rate around Z in dps.
+	 * @param ax Acceleration along X in g.
+	 * @param ay Acceleration along Y in g.
+	 * @param az Acceleration along Z in g.
+	 * @param timestampUs Sample time in microseconds, wrapping like micros().
+	 * @return True when the attitude was integrated.
+	 */
+	bool update(float gx, float gy, float gz, float ax, float ay, float az, uint32_t timestampUs) {
+		const uint32_t dtUs = timestampUs - _lastUs;
+		_lastUs = timestampUs;
+		if (!_started || dtUs == 0 || dtUs > MAX_DT_US) {
+			_started = true;
+			return false;
+		}
+		const float dt = dtUs * 1e-6f;
+
+		gx *= DEG_TO_RAD_F;
+		gy *= DEG_TO_RAD_F;
+		gz *= DEG_TO_RAD_F;
+
+		const float norm = ax * ax + ay * ay + az * az;
+		if (norm > 0.0f) {
+			const float inv = 1.0f / sqrtf(norm);
+			ax *= inv;
+			ay *= inv;
+			az *= inv;
+
+			// gravity direction predicted by the current attitude
+			const float vx = 2.0f * (_q1 * _q3 - _q0 * _q2);
+			const float vy = 2.0f * (_q0 * _q1 + _q2 * _q3);
+			const float vz = _q0 * _q0 - _q1 * _q1 - _q2 * _q2 + _q3 * _q3;
+
+			const float ex = ay * vz - az * vy;
+			const float ey = az * vx - ax * vz;
+			const float ez = ax * vy - ay * vx;
+
+			if (_ki > 0.0f) {
+				_biasX -= _ki * ex * dt;
+				_biasY -= _ki * ey * dt;
+				_biasZ -= _ki * ez * dt;
+			}
+			gx += _kp * ex;
+			gy += _kp * ey;
+			gz += _kp * ez;
+		}
+		gx -= _biasX;
+		gy -= _biasY;
+		gz -= _biasZ;
+
+		const float hx = 0.5f * dt * gx;
+		const float hy = 0.5f * dt * gy;
+		const float hz = 0.5f * dt * gz;
+		const float q0 = _q0, q1 = _q1, q2 = _q2, q3 = _q3;
+		_q0 += -q1 * hx - q2 * hy - q3 * hz;
+		_q1 += q0 * hx + q2 * hz - q3 * hy;
+		_q2 += q0 * hy - q1 * hz + q3 * hx;
+		_q3 += q0 * hz + q1 * hy - q2 * hx;
+
+		const float inv = 1.0f / sqrtf(_q0 * _q0 + _q1 * _q1 + _q2 * _q2 + _q3 * _q3);
+		_q0 *= inv;
+		_q1 *= inv;
+		_q2 *= inv;
+		_q3 *= inv;
+		return true;
+	}
+
+	/**
+	 * @brief Feed one FIFO record.
+	 * @param sample Record from ModulinoMovement::readFifo().
+	 * @return True when the attitude was integrated.
+	 */
+	bool update(const ModulinoMovement::Sample& sample) {
+		return update(sample.roll, sample.pitch, sample.yaw, sample.x, sample.y, sample.z, sample.timestamp);
+	}
+
+	/**
+	 * @brief Feed the values of the last ModulinoMovement::update(), timestamped now.
+	 * @param movement Movement module.
+	 * @return True when the attitude was integrated.
+	 */
+	bool update(ModulinoMovement& movement) {
+		return update(movement.getRoll(), movement.getPitch(), movement.getYaw(),
+			movement.getX(), movement.getY(), movement.getZ(), micros());
+	}
+
+	/** @brief Quaternion scalar part. */
+	float getQ0() const { return _q0; }
+	/** @brief Quaternion X part. */
+	float getQ1() const { return _q1; }
+	/** @brief Quaternion Y part. */
+	float getQ2() const { return _q2; }
+	/** @brief Quaternion Z part. */
+	float getQ3() const { return _q3; }
+
+	/**
+	 * @brief Get roll angle (rotation around X).
+	 * @return Angle in degrees.
+	 */
+	float getRoll() const {
+		return atan2f(2.0f * (_q0 * _q1 + _q2 * _q3), 1.0f - 2.0f * (_q1 * _q1 + _q2 * _q2)) * RAD_TO_DEG_F;
+	}
+
+	/**
+	 * @brief Get pitch angle (rotation around Y).
+	 * @return Angle in degrees.
+	 */
+	float getPitch() const {
+		float s = 2.0f * (_q0 * _q2 - _q3 * _q1);
+		s = s > 1.0f ? 1.0f : (s < -1.0f ? -1.0f : s);
+		return asinf(s) * RAD_TO_DEG_F;
+	}
+
+	/**
+	 * @brief Get yaw angle (rotation around Z), relative to the start heading.
+	 * @return Angle in degrees.
+	 */
+	float getYaw() const {
+		return atan2f(2.0f * (_q0 * _q3 + _q1 * _q2), 1.0f - 2.0f * (_q2 * _q2 + _q3 * _q3)) * RAD_TO_DEG_F;
+	}
+
+	/** @brief Estimated gyroscope bias around X in dps. */
+	float getGyroBiasX() const { return _biasX * RAD_TO_DEG_F; }
+	/** @brief Estimated gyroscope bias around Y in dps. */
+	float getGyroBiasY() const { return _biasY * RAD_TO_DEG_F; }
+	/** @brief Estimated gyroscope bias around Z in dps. */
+	float getGyroBiasZ() const { return _biasZ * RAD_TO_DEG_F; }
+
+private:
+	static constexpr float DEG_TO_RAD_F = 0.017453292519943295f;
+	static constexpr float RAD_TO_DEG_F = 57.29577951308232f;
+
+	float _kp;
+	float _ki;
+	float _q0 = 1.0f, _q1 = 0.0f, _q2 = 0.0f, _q3 = 0.0f;
+	float _biasX = 0.0f, _biasY = 0.0f, _biasZ = 0.0f;
+	uint32_t _lastUs = 0;
+	bool _started = false;
+};
+
+/**
+ * @brief Mahony orientation filter, fixed-point version for boards without an FPU.
+ * Same algorithm as ModulinoFusion. The quaternion and the error terms are Q2.30,
+ * angular rates are Q12.20 rad/s (the bias estimate Q36) and gains are Q16.16.
+ * The per-sample path of the raw update() uses integer arithmetic only; floats
+ * appear in the setters, the physical-unit overloads and the angle getters.
+ */
+class ModulinoFusionQ {
+public:
+	static constexpr uint32_t MAX_DT_US = 500000;
+	static constexpr int32_t Q30_ONE = 1L << 30;
+
+	/**
+	 * @brief Construct a filter.
+	 * @param kp Proportional gain.
+	 * @param ki Integral gain used for gyroscope bias estimation, 0 disables it.
+	 */
+	ModulinoFusionQ(float kp = 1.0f, float ki = 0.02f) {
+		setGains(kp, ki);
+	}
+
+	/**
+	 * @brief Set filter gains.
+	 * @param kp Proportional gain.
+	 * @param ki Integral gain, 0 disables bias estimation.
+	 */
+	void setGains(float kp, float ki) {
+		_kp = static_cast<int32_t>(kp * 65536.0f);
+		_ki = static_cast<int32_t>(ki * 65536.0f);
+	}
+
+	/**
+	 * @brief Set the gyroscope sensitivity used by the raw update().
+	 * @param dpsPerLsb Angular rate of one raw count in dps.
+	 */
+	void setGyroScale(float dpsPerLsb) {
+		// rad/s per LSB in Q20, kept with 12 extra fraction bits
+		_gyroScale = static_cast<int32_t>(dpsPerLsb * 0.017453292519943295f * 4294967296.0f);
+	}
+
+	/**
+	 * @brief Reset attitude to identity and clear the bias estimate.
+	 */
+	void reset() {
+		_q[0] = Q30_ONE;
+		_q[1] = _q[2] = _q[3] = 0;
+		_bias[0] = _bias[1] = _bias[2] = 0;
+		_started = false;
+	}
+
+	/**
+	 * @brief Feed one sample of raw sensor counts.
+	 * @param gyro Raw gyroscope counts X, Y, Z, scaled by setGyroScale().
+	 * @param accel Raw accelerometer counts X, Y, Z, any scale.
+	 * @param timestampUs Sample time in microseconds, wrapping like micros().
+	 * @return True when the attitude was integrated.
+	 */
+	bool update(const int16_t gyro[3], const int16_t accel[3], uint32_t timestampUs) {
+		int32_t g[3];
+		for (uint8_t i = 0; i < 3; i++) {
+			g[i] = static_cast<int32_t>((static_cast<int64_t>(gyro[i]) * _gyroScale) >> 12);
+		}
+		const int32_t a[3] = { accel[0], accel[1], accel[2] };
+		return integrate(g, a, timestampUs);
+	}
+
+	/**
+	 * @brief Feed one sample in physical units.
+	 * @param gx Angular rate around X in dps.
+	 * @param gy Angular rate around Y in dps.
+	 * @param gz Angular rate around Z in dps.
+	 * @param ax Acceleration along X in g.
+	 * @param ay Acceleration along Y in g.
+	 * @param az Acceleration along Z in g.
+	 * @param timestampUs Sample time in microseconds, wrapping like micros().
+	 * @return True when the attitude was integrated.
+	 */
+	bool update(float gx, float gy, float gz, float ax, float ay, float az, uint32_t timestampUs) {
+		const float toQ20 = 0.017453292519943295f * 1048576.0f;
+		const int32_t g[3] = {
+			static_cast<int32_t>(gx * toQ20), static_cast<int32_t>(gy * toQ20), static_cast<int32_t>(gz * toQ20)
+		};
+		const int32_t a[3] = {
+			static_cast<int32_t>(ax * 16384.0f), static_cast<int32_t>(ay * 16384.0f), static_cast<int32_t>(az * 16384.0f)
+		};
+		return integrate(g, a, timestampUs);
+	}
+
+	/**
+	 * @brief Feed one FIFO record.
+	 * @param sample Record from ModulinoMovement::readFifo().
+	 * @return True when the attitude was integrated.
+	 */
+	bool update(const ModulinoMovement::Sample& sample) {
+		return update(sample.roll, sample.pitch, sample.yaw, sample.x, sample.y, sample.z, sample.timestamp);
+	}
+
+	/**
+	 * @brief Feed the values of the last ModulinoMovement::update(), timestamped now.
+	 * @param movement Movement module.
+	 * @return True when the attitude was integrated.
+	 */
+	bool update(ModulinoMovement& movement) {
+		return update(movement.getRoll(), movement.getPitch(), movement.getYaw(),
+			movement.getX(), movement.getY(), movement.getZ(), micros());
+	}
+
+	/**
+	 * @brief Get a quaternion component in Q2.30.
+	 * @param index 0 for the scalar part, 1..3 for X, Y, Z.
+	 * @return Component, Q30_ONE is 1.0.
+	 */
+	int32_t getQuaternion(uint8_t index) const {
+		return index < 4 ? _q[index] : 0;
+	}
+
+	/** @brief Quaternion scalar part. */
+	float getQ0() const { return _q[0] / static_cast<float>(Q30_ONE); }
+	/** @brief Quaternion X part. */
+	float getQ1() const { return _q[1] / static_cast<float>(Q30_ONE); }
+	/** @brief Quaternion Y part. */
+	float getQ2() const { return _q[2] / static_cast<float>(Q30_ONE); }
+	/** @brief Quaternion Z part. */
+	float getQ3() const { return _q[3] / static_cast<float>(Q30_ONE); }
+
+	/**
+	 * @brief Get roll angle (rotation around X).
+	 * @return Angle in degrees.
+	 */
+	float getRoll() const {
+		const float q0 = getQ0(), q1 = getQ1(), q2 = getQ2(), q3 = getQ3();
+		return atan2f(2.0f * (q0 * q1 + q2 * q3), 1.0f - 2.0f * (q1 * q1 + q2 * q2)) * 57.29577951308232f;
+	}
+
+	/**
+	 * @brief Get pitch angle (rotation around Y).
+	 * @return Angle in degrees.
+	 */
+	float getPitch() const {
+		const float q0 = getQ0(), q1 = getQ1(), q2 = getQ2(), q3 = getQ3();
+		float s = 2.0f * (q0 * q2 - q3 * q1);
+		s = s > 1.0f ? 1.0f : (s < -1.0f ? -1.0f : s);
+		return asinf(s) * 57.29577951308232f;
+	}
+
+	/**
+	 * @brief Get yaw angle (rotation around Z), relative to the start heading.
+	 * @return Angle in degrees.
+	 */
+	float getYaw() const {
+		const float q0 = getQ0(), q1 = getQ1(), q2 = getQ2(), q3 = getQ3();
+		return atan2f(2.0f * (q0 * q3 + q1 * q2), 1.0f - 2.0f * (q2 * q2 + q3 * q3)) * 57.29577951308232f;
+	}
+
+	/** @brief Estimated gyroscope bias around X in dps. */
+	float getGyroBiasX() const { return _bias[0] * BIAS_TO_DPS; }
+	/** @brief Estimated gyroscope bias around Y in dps. */
+	float getGyroBiasY() const { return _bias[1] * BIAS_TO_DPS; }
+	/** @brief Estimated gyroscope bias around Z in dps. */
+	float getGyroBiasZ() const { return _bias[2] * BIAS_TO_DPS; }
+
+private:
+	static constexpr float BIAS_TO_DPS = 57.29577951308232f / 68719476736.0f;
+
+	static int32_t mulQ30(int32_t a, int32_t b) {
+		return static_cast<int32_t>((static_cast<int64_t>(a) * b) >> 30);
+	}
+
+	static uint32_t isqrt64(uint64_t value) {
+		uint64_t result = 0;
+		uint64_t bit = 1ULL << 62;
+		while (bit > value) {
+			bit >>= 2;
+		}
+		while (bit != 0) {
+			if (value >= result + bit) {
+				value -= result + bit;
+				result = (result >> 1) + bit;
+			} else {
+				result >>= 1;
+			}
+			bit >>= 2;
+		}
+		return static_cast<uint32_t>(result);
+	}
+
+	/**
+	 * @brief Core filter step.
+	 * @param g Angular rate in Q20 rad/s.
+	 * @param a Acceleration in any linear scale.
+	 */
+	bool integrate(const int32_t g[3], const int32_t a[3], uint32_t timestampUs) {
+		const uint32_t dtUs = timestampUs - _lastUs;
+		_lastUs = timestampUs;
+		if (!_started || dtUs == 0 || dtUs > MAX_DT_US) {
+			_started = true;
+			return false;
+		}
+
+		int32_t w[3] = { g[0], g[1], g[2] };
+		const uint64_t norm2 = static_cast<uint64_t>(static_cast<int64_t>(a[0]) * a[0] +
+			static_cast<int64_t>(a[1]) * a[1] + static_cast<int64_t>(a[2]) * a[2]);
+		if (norm2 > 0) {
+			const int64_t norm = isqrt64(norm2);
+			int32_t an[3];
+			for (uint8_t i = 0; i < 3; i++) {
+				an[i] = static_cast<int32_t>((static_cast<int64_t>(a[i]) << 30) / norm);
+			}
+
+			// gravity direction predicted by the current attitude, Q30
+			const int32_t vx = 2 * (mulQ30(_q[1], _q[3]) - mulQ30(_q[0], _q[2]));
+			const int32_t vy = 2 * (mulQ30(_q[0], _q[1]) + mulQ30(_q[2], _q[3]));
+			const int32_t vz = mulQ30(_q[0], _q[0]) - mulQ30(_q[1], _q[1]) - mulQ30(_q[2], _q[2]) + mulQ30(_q[3], _q[3]);
+
+			const int32_t e[3] = {
+				mulQ30(an[1], vz) - mulQ30(an[2], vy),
+				mulQ30(an[2], vx) - mulQ30(an[0], vz),
+				mulQ30(an[0], vy) - mulQ30(an[1], vx)
+			};
+
+			for (uint8_t i = 0; i < 3; i++) {
+				// Q30 * Q16 >> 26 gives Q20 rad/s; the bias keeps 16 more bits
+				// so slow convergence steps are not lost to truncation
+				if (_ki > 0) {
+					const int64_t rate = (static_cast<int64_t>(e[i]) * _ki) >> 10;
+					_bias[i] -= (rate * dtUs) / 1000000;
+				}
+				w[i] += static_cast<int32_t>((static_cast<int64_t>(e[i]) * _kp) >> 26);
+			}
+		}
+
+		// half rotation angle in Q30: Q20 rad/s * us / 1e6 << 10, halved
+		int32_t h[3];
+		for (uint8_t i = 0; i < 3; i++) {
+			const int64_t rate = static_cast<int64_t>(w[i]) - (_bias[i] >> 16);
+			h[i] = static_cast<int32_t>((rate * dtUs * 512) / 1000000);
+		}
+		const int32_t q0 = _q[0], q1 = _q[1], q2 = _q[2], q3 = _q[3];
+		_q[0] += -mulQ30(q1, h[0]) - mulQ30(q2, h[1]) - mulQ30(q3, h[2]);
+		_q[1] += mulQ30(q0, h[0]) + mulQ30(q2, h[2]) - mulQ30(q3, h[1]);
+		_q[2] += mulQ30(q0, h[1]) - mulQ30(q1, h[2]) + mulQ30(q3, h[0]);
+		_q[3] += mulQ30(q0, h[2]) + mulQ30(q1, h[1]) - mulQ30(q2, h[0]);
+
+		// one Newton step of 1/sqrt around 1 keeps |q| normalized
+		int64_t n2 = 0;
+		for (uint8_t i = 0; i < 4; i++) {
+			n2 += (static_cast<int64_t>(_q[i]) * _q[i]) >> 30;
+		}
+		const int32_t inv = static_cast<int32_t>((3LL * Q30_ONE - n2) >> 1);
+		for (uint8_t i = 0; i < 4; i++) {
+			_q[i] = mulQ30(_q[i], inv);
+		}
+		return true;
+	}
+
+	int32_t _kp;
+	int32_t _ki;
+	int32_t _gyroScale = static_cast<int32_t>(2000.0f / 32768.0f * 0.017453292519943295f * 4294967296.0f);
+	int32_t _q[4] = { Q30_ONE, 0, 0, 0 };
+	int64_t _bias[3] = { 0, 0, 0 };  // Q36 rad/s
+	uint32_t _lastUs = 0;
+	bool _started = false;
+};
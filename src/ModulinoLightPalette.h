@@ -0,0 +1,310 @@
+#pragma once
+
+#include "Modulino.h"
+
+/**
+ * @brief Nearest-color matching of Modulino Light readings against a user palette.
+ * Readings are first corrected with a dark offset, a white balance and an optional
+ * 3x3 crosstalk matrix. build() then precomputes, for every cell of a quantized
+ * corrected RGB cube, the palette entry closest in CIELAB space, so match() is a
+ * correction plus a single table lookup.
+ * @tparam MAX_COLORS Palette capacity, at most 254.
+ * @tparam GRID_BITS Lookup resolution per channel; the table takes 2^(3 * GRID_BITS) bytes.
+ */
+template<uint8_t MAX_COLORS = 32, uint8_t GRID_BITS = 4>
+class ModulinoLightPalette {
+	static_assert(MAX_COLORS < 255, "MAX_COLORS must leave room for NO_MATCH");
+	static_assert(GRID_BITS >= 2 && GRID_BITS <= 6, "GRID_BITS must be 2..6");
+
+public:
+	static constexpr uint8_t NO_MATCH = 0xFF;
+	static constexpr uint8_t GRID_LEVELS = 1 << GRID_BITS;
+	static constexpr uint32_t TABLE_SIZE = (uint32_t)GRID_LEVELS * GRID_LEVELS * GRID_LEVELS;
+
+	ModulinoLightPalette() {
+		resetCalibration();
+		clear();
+	}
+
+	/**
+	 * @brief Record the dark reference with the sensor covered.
+	 * @param light Initialized light module, updated @p samples times.
+	 * @param samples Number of readings averaged.
+	 * @return True when all readings succeeded and are darker than the white reference.
+	 */
+	bool calibrateDark(ModulinoLight& light, uint8_t samples = 8) {
+		uint16_t avg[3];
+		if (!average(light, samples, avg)) {
+			return false;
+		}
+		for (uint8_t i = 0; i < 3; i++) {
+			if (avg[i] >= _white[i]) {
+				return false;
+			}
+		}
+		for (uint8_t i = 0; i < 3; i++) {
+			_dark[i] = avg[i];
+		}
+		updateMatrix();
+		return true;
+	}
+
+	/**
+	 * @brief Record the white reference with the sensor over a white target.
+	 * Calibrate before adding palette entries from readings.
+	 * @param light Initialized light module, updated @p samples times.
+	 * @param samples Number of readings averaged.
+	 * @return True when all readings succeeded and are brighter than the dark reference.
+	 */
+	bool calibrateWhite(ModulinoLight& light, uint8_t samples = 8) {
+		uint16_t avg[3];
+		if (!average(light, samples, avg)) {
+			return false;
+		}
+		for (uint8_t i = 0; i < 3; i++) {
+			if (avg[i] <= _dark[i]) {
+				return false;
+			}
+		}
+		for (uint8_t i = 0; i < 3; i++) {
+			_white[i] = avg[i];
+		}
+		updateMatrix();
+		return true;
+	}
+
+	/**
+	 * @brief Set a crosstalk matrix applied after the white balance.
+	 * @param matrix Row-major 3x3 matrix, identity by default.
+	 */
+	void setCrosstalk(const float* matrix) {
+		for (uint8_t i = 0; i < 9; i++) {
+			_crosstalk[i] = matrix[i];
+		}
+		updateMatrix();
+	}
+
+	/**
+	 * @brief Forget dark, white and crosstalk calibration.
+	 */
+	void resetCalibration() {
+		for (uint8_t i = 0; i < 3; i++) {
+			_dark[i] = 0;
+			_white[i] = 255;
+		}
+		for (uint8_t i = 0; i < 9; i++) {
+			_crosstalk[i] = (i % 4 == 0) ? 1.0f : 0.0f;
+		}
+		updateMatrix();
+	}
+
+	/**
+	 * @brief Apply the correction to a reading.
+	 * @param r Red reading, 0-255.
+	 * @param g Green reading, 0-255.
+	 * @param b Blue reading, 0-255.
+	 * @param out Corrected red, green and blue, 0-255.
+	 */
+	void correct(int r, int g, int b, uint8_t* out) const {
+		const int32_t in[3] = {r - _dark[0], g - _dark[1], b - _dark[2]};
+		for (uint8_t i = 0; i < 3; i++) {
+			int32_t v = (_matrix[i * 3] * in[0] + _matrix[i * 3 + 1] * in[1] + _matrix[i * 3 + 2] * in[2]) >> MATRIX_SHIFT;
+			out[i] = v < 0 ? 0 : (v > 255 ? 255 : v);
+		}
+	}
+
+	/**
+	 * @brief Add a palette entry from the current target, averaging fresh readings.
+	 * @param light Initialized light module, updated @p samples times.
+	 * @param samples Number of readings averaged.
+	 * @return Index of the new entry, -1 if the palette is full or a reading failed.
+	 */
+	int addColor(ModulinoLight& light, uint8_t samples = 8) {
+		uint16_t avg[3];
+		if (_colors >= MAX_COLORS || !average(light, samples, avg)) {
+			return -1;
+		}
+		uint8_t c[3];
+		correct(avg[0], avg[1], avg[2], c);
+		return addCorrected(c[0], c[1], c[2]);
+	}
+
+	/**
+	 * @brief Add a palette entry given in corrected color space, e.g. a known sRGB value.
+	 * @return Index of the new entry, -1 if the palette is full.
+	 */
+	int addCorrected(uint8_t r, uint8_t g, uint8_t b) {
+		if (_colors >= MAX_COLORS) {
+			return -1;
+		}
+		toLab(r, g, b, _lab[_colors]);
+		_built = false;
+		return _colors++;
+	}
+
+	/**
+	 * @brief Remove all palette entries.
+	 */
+	void clear() {
+		_colors = 0;
+		_built = false;
+	}
+
+	/**
+	 * @brief Get the number of palette entries.
+	 */
+	uint8_t colors() const {
+		return _colors;
+	}
+
+	/**
+	 * @brief Limit matches to entries within a CIELAB distance.
+	 * Takes effect on the next build().
+	 * @param deltaE Maximum CIE76 distance, 0 for no limit.
+	 */
+	void setMaxDistance(float deltaE) {
+		_maxDistance2 = deltaE * deltaE;
+		_built = false;
+	}
+
+	/**
+	 * @brief Precompute the nearest palette entry for every cell of the lookup table.
+	 * Runs once after the palette or the distance limit changed; calibration changes
+	 * only affect readings, so they do not require a rebuild.
+	 * @return False if the palette is empty.
+	 */
+	bool build() {
+		if (_colors == 0) {
+			return false;
+		}
+		uint32_t cell = 0;
+		for (uint8_t ri = 0; ri < GRID_LEVELS; ri++) {
+			for (uint8_t gi = 0; gi < GRID_LEVELS; gi++) {
+				for (uint8_t bi = 0; bi < GRID_LEVELS; bi++) {
+					float lab[3];
+					toLab(cellCenter(ri), cellCenter(gi), cellCenter(bi), lab);
+					uint8_t best = NO_MATCH;
+					float bestDistance = _maxDistance2 > 0 ? _maxDistance2 : 1e30f;
+					for (uint8_t i = 0; i < _colors; i++) {
+						const float dl = lab[0] - _lab[i][0];
+						const float da = lab[1] - _lab[i][1];
+						const float db = lab[2] - _lab[i][2];
+						const float d = dl * dl + da * da + db * db;
+						if (d <= bestDistance) {
+							bestDistance = d;
+							best = i;
+						}
+					}
+					_table[cell++] = best;
+				}
+			}
+		}
+		_built = true;
+		return true;
+	}
+
+	/**
+	 * @brief Check whether the lookup table matches the current palette.
+	 */
+	bool built() const {
+		return _built;
+	}
+
+	/**
+	 * @brief Match the last reading of a light module, call after its update().
+	 * @return Palette index, or NO_MATCH if none is close enough or build() is pending.
+	 */
+	uint8_t match(ModulinoLight& light) const {
+		const uint32_t rgb = light.getColor();
+		return match((rgb >> 24) & 0xFF, (rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF);
+	}
+
+	/**
+	 * @brief Match an uncorrected reading.
+	 * @return Palette index, or NO_MATCH if none is close enough or build() is pending.
+	 */
+	uint8_t match(int r, int g, int b) const {
+		if (!_built) {
+			return NO_MATCH;
+		}
+		uint8_t c[3];
+		correct(r, g, b, c);
+		constexpr uint8_t shift = 8 - GRID_BITS;
+		return _table[((uint32_t)(c[0] >> shift) << (2 * GRID_BITS)) | ((c[1] >> shift) << GRID_BITS) | (c[2] >> shift)];
+	}
+
+private:
+	static constexpr uint8_t MATRIX_SHIFT = 12;
+
+	static uint8_t cellCenter(uint8_t index) {
+		return (index << (8 - GRID_BITS)) + (1 << (7 - GRID_BITS));
+	}
+
+	/**
+	 * @brief Fold dark offset, white balance and crosstalk into one fixed-point matrix.
+	 */
+	void updateMatrix() {
+		for (uint8_t row = 0; row < 3; row++) {
+			for (uint8_t col = 0; col < 3; col++) {
+				const float gain = 255.0f / (_white[col] - _dark[col]);
+				_matrix[row * 3 + col] = lroundf(_crosstalk[row * 3 + col] * gain * (1 << MATRIX_SHIFT));
+			}
+		}
+	}
+
+	static bool average(ModulinoLight& light, uint8_t samples, uint16_t* out) {
+		uint32_t sum[3] = {0, 0, 0};
+		if (samples == 0) {
+			samples = 1;
+		}
+		for (uint8_t n = 0; n < samples; n++) {
+			if (!light.update()) {
+				return false;
+			}
+			const uint32_t rgb = light.getColor();
+			sum[0] += (rgb >> 24) & 0xFF;
+			sum[1] += (rgb >> 16) & 0xFF;
+			sum[2] += (rgb >> 8) & 0xFF;
+		}
+		for (uint8_t i = 0; i < 3; i++) {
+			out[i] = (sum[i] + samples / 2) / samples;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Convert corrected sRGB to CIELAB (D65 white).
+	 */
+	static void toLab(uint8_t r, uint8_t g, uint8_t b, float* lab) {
+		const float rl = linear(r);
+		const float gl = linear(g);
+		const float bl = linear(b);
+		const float x = labF((0.4124f * rl + 0.3576f * gl + 0.1805f * bl) / 0.95047f);
+		const float y = labF(0.2126f * rl + 0.7152f * gl + 0.0722f * bl);
+		const float z = labF((0.0193f * rl + 0.1192f * gl + 0.9505f * bl) / 1.08883f);
+		lab[0] = 116.0f * y - 16.0f;
+		lab[1] = 500.0f * (x - y);
+		lab[2] = 200.0f * (y - z);
+	}
+
+	static float linear(uint8_t c) {
+		const float v = c / 255.0f;
+		return v <= 0.04045f ? v / 12.92f : powf((v + 0.055f) / 1.055f, 2.4f);
+	}
+
+	static float labF(float t) {
+		return t > 0.008856f ? cbrtf(t) : 7.787f * t + 16.0f / 116.0f;
+	}
+
+	int16_t _dark[3];
+	int16_t _white[3];
+	float _crosstalk[9];
+	int32_t _matrix[9];
+
+	float _lab[MAX_COLORS][3];
+	uint8_t _colors = 0;
+	float _maxDistance2 = 0;
+
+	uint8_t _table[TABLE_SIZE];
+	bool _built = false;
+};
@@ -21,6 +21,26 @@ public:
 		FAST = 3,
 	};
 
+	/**
+	 * @brief Current draw measured at one DC PWM frequency.
+	 */
+	struct FrequencySample {
+		uint16_t frequencyHz;  ///< PWM frequency in Hz.
+		float meanMa;          ///< Mean of A+B sensed current in mA.
+		float rippleMa;        ///< Standard deviation of A+B sensed current in mA.
+	};
+
+	/**
+	 * @brief Charge and energy accumulated over an interval of telemetry polls.
+	 */
+	struct EnergyReport {
+		float chargeMahA;     ///< Channel A charge in mAh.
+		float chargeMahB;     ///< Channel B charge in mAh.
+		float energyJA;       ///< Channel A energy in joules at the configured supply voltage.
+		float energyJB;       ///< Channel B energy in joules at the configured supply voltage.
+		uint32_t durationMs;  ///< Integrated time in milliseconds.
+	};
+
 	static constexpr uint8_t MODE_DC = 0;
 	static constexpr uint8_t MODE_STEPPER = 1;
 
@@ -30,6 +50,9 @@ public:
 	static constexpr uint16_t ISEN_RESISTOR_OHMS = 4700;
 	static constexpr uint16_t KISEN_FULL_SCALE = 7500;
 	static constexpr uint16_t KISEN_HALF_SCALE = 3750;
+	static constexpr int16_t RAMP_RESOLUTION = MAX_SPEED / 100;
+	static constexpr uint16_t MIN_FREQUENCY = 200;
+	static constexpr uint16_t MAX_FREQUENCY = 60000;
 
 	/**
 	 * @brief Construct a Modulino Motors instance.
@@ -90,6 +113,7 @@ public:
 	 * @return True on successful command write.
 	 */
 	bool stop() {
+		abortMove();
 		return setDcSpeedRaw(0, 0);
 	}
 
@@ -100,6 +124,7 @@ public:
 	bool release() {
 		// releaseDelayMs = 1 (minimum non-zero delay in current protocol)
 		uint8_t cmd[8] = {CMD_STEPPER, 0, 0, 0, 0, 1, 0, 1};
+		abortMove();
 		return sendCommand(cmd, sizeof(cmd));
 	}
 
@@ -109,6 +134,7 @@ public:
 	 */
 	bool hold() {
 		uint8_t cmd[8] = {CMD_STEPPER, 0, 0, 0, 0, 1, 0, 0};
+		abortMove();
 		return sendCommand(cmd, sizeof(cmd));
 	}
 
@@ -217,13 +243,99 @@ public:
 			return false;
 		}
 
-		uint8_t cmd[5];
-		cmd[0] = CMD_SPEED_DC;
-		cmd[1] = static_cast<uint8_t>(speedA & 0xFF);
-		cmd[2] = static_cast<uint8_t>((speedA >> 8) & 0xFF);
-		cmd[3] = static_cast<uint8_t>(speedB & 0xFF);
-		cmd[4] = static_cast<uint8_t>((speedB >> 8) & 0xFF);
-		return sendCommand(cmd, sizeof(cmd));
+		beginEnergySegment();
+		_rampTargetA = _rampCurrentA = speedA;
+		_rampTargetB = _rampCurrentB = speedB;
+		return sendDcSpeed(speedA, speedB);
+	}
+
+	/**
+	 * @brief Set the DC speed slew rate used by setSpeedA(), setSpeedB() and the invert setters.
+	 * With a non-zero rate those calls only change the target and tick() ramps towards it.
+	 * setDcSpeedRaw() and stop() always apply immediately.
+	 * @param percentPerSecond Maximum speed change in percent of full scale per second, 0 disables ramping.
+	 */
+	void setAcceleration(uint16_t percentPerSecond) {
+		_accelRawPerSec = (static_cast<uint32_t>(percentPerSecond) * MAX_SPEED) / 100;
+		_rampLastUs = micros();
+	}
+
+	/**
+	 * @brief Get the DC speed slew rate.
+	 * @return Maximum speed change in percent of full scale per second, 0 when ramping is disabled.
+	 */
+	uint16_t acceleration() const {
+		return static_cast<uint16_t>((_accelRawPerSec * 100 + MAX_SPEED / 2) / MAX_SPEED);
+	}
+
+	/**
+	 * @brief Set raw signed DC speed targets reached through the configured slew rate.
+	 * Falls back to setDcSpeedRaw() when ramping is disabled.
+	 * @param speedA Raw signed target for A in range -32767..32767.
+	 * @param speedB Raw signed target for B in range -32767..32767.
+	 * @return True if accepted; a command is only sent once the ramp output changes.
+	 */
+	bool rampDcSpeedRaw(int16_t speedA, int16_t speedB) {
+		if (speedA < -MAX_SPEED || speedA > MAX_SPEED || speedB < -MAX_SPEED || speedB > MAX_SPEED) {
+			return false;
+		}
+		if (_accelRawPerSec == 0) {
+			return setDcSpeedRaw(speedA, speedB);
+		}
+		beginEnergySegment();
+		if (!ramping()) {
+			// restart the time base so an idle period does not turn into one big jump
+			_rampLastUs = micros();
+		}
+		_rampTargetA = speedA;
+		_rampTargetB = speedB;
+		return tick();
+	}
+
+	/**
+	 * @brief Advance the DC speed ramp, call it periodically from loop().
+	 * Both channels are stepped together and sent in one command, and only when
+	 * the value quantized to RAMP_RESOLUTION differs from the last one sent.
+	 * @return False if a required command write failed.
+	 */
+	bool tick() {
+		if (!ramping()) {
+			return true;
+		}
+		const uint32_t now = micros();
+		const uint32_t elapsed = now - _rampLastUs;
+		const uint32_t maxDelta = static_cast<uint32_t>((static_cast<uint64_t>(_accelRawPerSec) * elapsed) / 1000000UL);
+		if (maxDelta == 0) {
+			return true;
+		}
+		_rampLastUs = now;
+		_rampCurrentA = rampStep(_rampCurrentA, _rampTargetA, maxDelta);
+		_rampCurrentB = rampStep(_rampCurrentB, _rampTargetB, maxDelta);
+
+		const int16_t outA = rampQuantize(_rampCurrentA, _rampTargetA);
+		const int16_t outB = rampQuantize(_rampCurrentB, _rampTargetB);
+		if (outA == _sentRawA && outB == _sentRawB) {
+			return true;
+		}
+		return sendDcSpeed(outA, outB);
+	}
+
+	/**
+	 * @brief Check whether a DC speed ramp is still in progress.
+	 * @return True until both channels reached their target.
+	 */
+	bool ramping() const {
+		return _rampCurrentA != _rampTargetA || _rampCurrentB != _rampTargetB;
+	}
+
+	/**
+	 * @brief Get the raw DC speeds last sent to the module.
+	 * @param speedA Receives the raw signed speed for A.
+	 * @param speedB Receives the raw signed speed for B.
+	 */
+	void dcSpeedRaw(int16_t& speedA, int16_t& speedB) const {
+		speedA = _sentRawA;
+		speedB = _sentRawB;
 	}
 
 	/**
@@ -255,7 +367,17 @@ public:
 		cmd[5] = static_cast<uint8_t>(speedPeriod & 0xFF);
 		cmd[6] = static_cast<uint8_t>((speedPeriod >> 8) & 0xFF);
 		cmd[7] = releaseDelayMs;
-		return sendCommand(cmd, sizeof(cmd));
+		abortMove();
+		beginEnergySegment();
+		const bool ok = sendCommand(cmd, sizeof(cmd));
+		if (ok && steps != 0) {
+			_moveActive = true;
+			_moveStartUs = micros();
+			_moveSteps = static_cast<uint32_t>(steps < 0 ? -static_cast<int64_t>(steps) : steps);
+			_moveUnits = static_cast<int8_t>((steps < 0 ? -1 : 1) * (_halfStepEnabled ? 1 : 2));
+			_movePeriod = speedPeriod;
+		}
+		return ok;
 	}
 
 	/**
@@ -286,6 +408,127 @@ public:
 		return moveStepper(steps, periodTicks, releaseDelayMs);
 	}
 
+	/**
+	 * @brief Command a stepper move to an absolute position.
+	 * @param position Target position in steps of the current step mode.
+	 * @param speedPeriod Step period in 0.1 ms timer ticks (1..65535).
+	 * @param releaseDelayMs Delay before releasing coils after move completion.
+	 * @return True on successful command write.
+	 */
+	bool moveTo(int32_t position, uint16_t speedPeriod, uint8_t releaseDelayMs = 0) {
+		return moveStepper(position - this->position(), speedPeriod, releaseDelayMs);
+	}
+
+	/**
+	 * @brief Get the estimated absolute stepper position.
+	 * Completed moves are counted in full. For a move in progress, or one cut short by
+	 * stop(), hold() or release(), progress is estimated from the elapsed time and step period.
+	 * Position is kept in half-steps internally, so switching step mode keeps the origin.
+	 * @return Position in steps of the current step mode.
+	 */
+	int32_t position() {
+		settleMove();
+		const int32_t units = _positionUnits + movedUnits();
+		const int32_t steps = _halfStepEnabled ? units : units / 2;
+		return _stepperDirectionInverted ? -steps : steps;
+	}
+
+	/**
+	 * @brief Get the absolute position the current move will end at.
+	 * @return Target position in steps of the current step mode.
+	 */
+	int32_t targetPosition() const {
+		int32_t units = _positionUnits;
+		if (_moveActive) {
+			units += static_cast<int32_t>(_moveSteps) * _moveUnits;
+		}
+		const int32_t steps = _halfStepEnabled ? units : units / 2;
+		return _stepperDirectionInverted ? -steps : steps;
+	}
+
+	/**
+	 * @brief Check whether a stepper move is expected to still be running.
+	 * @return True until the estimated end time of the last move has passed.
+	 */
+	bool moving() {
+		settleMove();
+		return _moveActive;
+	}
+
+	/**
+	 * @brief Redefine the current stepper position without moving.
+	 * Any move in progress is counted as far as it got so far.
+	 * @param position New position in steps of the current step mode.
+	 */
+	void setPosition(int32_t position) {
+		abortMove();
+		if (_stepperDirectionInverted) {
+			position = -position;
+		}
+		_positionUnits = position * (_halfStepEnabled ? 1 : 2);
+	}
+
+	/**
+	 * @brief Home the stepper against a digital limit input.
+	 * Moves towards the limit until @p pin reads @p activeLevel, then holds and sets the position.
+	 * This call blocks until the limit is hit or the move ends.
+	 * @param pin Limit switch input pin, configured by the caller.
+	 * @param activeLevel Pin level that means the limit is reached.
+	 * @param maxSteps Signed travel limit, its sign selects the homing direction.
+	 * @param speedPeriod Step period in 0.1 ms timer ticks (1..65535).
+	 * @param homePosition Position assigned at the limit.
+	 * @return True when the limit was reached.
+	 */
+	bool home(int pin, PinStatus activeLevel, int32_t maxSteps, uint16_t speedPeriod, int32_t homePosition = 0) {
+		if (digitalRead(pin) == activeLevel) {
+			hold();
+			setPosition(homePosition);
+			return true;
+		}
+		if (maxSteps == 0 || !moveStepper(maxSteps, speedPeriod)) {
+			return false;
+		}
+		while (moving()) {
+			if (digitalRead(pin) == activeLevel) {
+				hold();
+				setPosition(homePosition);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Home the stepper against a limit reported by a callback.
+	 * Use this when the limit comes from another module, e.g. a Modulino Buttons press.
+	 * @param limitReached Function returning true once the limit is reached.
+	 * @param maxSteps Signed travel limit, its sign selects the homing direction.
+	 * @param speedPeriod Step period in 0.1 ms timer ticks (1..65535).
+	 * @param homePosition Position assigned at the limit.
+	 * @return True when the limit was reached.
+	 */
+	bool home(bool (*limitReached)(), int32_t maxSteps, uint16_t speedPeriod, int32_t homePosition = 0) {
+		if (limitReached == nullptr || maxSteps == 0) {
+			return false;
+		}
+		if (limitReached()) {
+			hold();
+			setPosition(homePosition);
+			return true;
+		}
+		if (!moveStepper(maxSteps, speedPeriod)) {
+			return false;
+		}
+		while (moving()) {
+			if (limitReached()) {
+				hold();
+				setPosition(homePosition);
+				return true;
+			}
+		}
+		return false;
+	}
+
 	/**
 	 * @brief Set decay mode using a typed enum.
 	 * @param decayMode Desired decay mode.
@@ -318,7 +561,7 @@ public:
 	 * @return True on successful command write.
 	 */
 	bool setFrequency(uint16_t frequencyHz) {
-		if (frequencyHz < 200 || frequencyHz > 60000) {
+		if (frequencyHz < MIN_FREQUENCY || frequencyHz > MAX_FREQUENCY) {
 			return false;
 		}
 		uint8_t cmd[3];
@@ -332,6 +575,132 @@ public:
 		return ok;
 	}
 
+	/**
+	 * @brief Measure mean and ripple current at one DC PWM frequency.
+	 * The motors keep running at their current speed. This call blocks for about
+	 * settleMs + samples * FREQUENCY_SAMPLE_INTERVAL_MS milliseconds.
+	 * @param frequencyHz PWM frequency in Hz (200..60000).
+	 * @param sample Receives the measurement.
+	 * @param samples Number of telemetry reads to average.
+	 * @param settleMs Time to wait after the frequency change before sampling.
+	 * @return True when the frequency was set and at least one sample was read.
+	 */
+	bool measureFrequency(uint16_t frequencyHz, FrequencySample& sample, uint8_t samples = 16, uint16_t settleMs = 100) {
+		if (samples == 0 || !setFrequency(frequencyHz)) {
+			return false;
+		}
+		delay(settleMs);
+		float sum = 0.0f;
+		float sumSq = 0.0f;
+		uint8_t count = 0;
+		for (uint8_t i = 0; i < samples; i++) {
+			if (update()) {
+				const float ma = sensedCurrentA() + sensedCurrentB();
+				sum += ma;
+				sumSq += ma * ma;
+				count++;
+			}
+			delay(FREQUENCY_SAMPLE_INTERVAL_MS);
+		}
+		if (count == 0) {
+			return false;
+		}
+		const float mean = sum / count;
+		const float variance = sumSq / count - mean * mean;
+		sample.frequencyHz = frequencyHz;
+		sample.meanMa = mean;
+		sample.rippleMa = variance > 0.0f ? sqrtf(variance) : 0.0f;
+		return true;
+	}
+
+	/**
+	 * @brief Measure current draw at evenly spaced DC PWM frequencies.
+	 * @param fromHz First frequency in Hz (200..60000).
+	 * @param toHz Last frequency in Hz (200..60000).
+	 * @param points Number of frequencies to measure, including both ends.
+	 * @param logarithmic True to space points geometrically, false for linear spacing.
+	 * @param results Receives one sample per successfully measured point.
+	 * @param maxResults Capacity of @p results.
+	 * @param samples Telemetry reads averaged per point.
+	 * @return Number of samples written to @p results.
+	 */
+	size_t sweepFrequency(uint16_t fromHz, uint16_t toHz, uint8_t points, bool logarithmic,
+			FrequencySample* results, size_t maxResults, uint8_t samples = 16) {
+		size_t written = 0;
+		for (uint8_t i = 0; i < points && written < maxResults; i++) {
+			if (measureFrequency(sweepPoint(fromHz, toHz, i, points, logarithmic), results[written], samples)) {
+				written++;
+			}
+		}
+		return written;
+	}
+
+	/**
+	 * @brief Find the DC PWM frequency with the lowest current draw at a given speed.
+	 * Runs a logarithmic coarse sweep over 200..60000 Hz, then a linear fine sweep
+	 * between the neighbours of the best coarse point, and applies the best frequency.
+	 * Both motor channels are driven at @p speedPercent and keep running afterwards.
+	 * @param speedPercent Speed applied to both channels while tuning, 1..100.
+	 * @param results Optional buffer receiving every measured point, coarse first.
+	 * @param maxResults Capacity of @p results.
+	 * @param coarsePoints Number of coarse sweep points, at least 2.
+	 * @param finePoints Number of fine sweep points.
+	 * @return Selected frequency in Hz, or 0 if nothing could be measured; the
+	 * previous frequency is restored in that case.
+	 */
+	uint16_t autoTuneFrequency(uint8_t speedPercent, FrequencySample* results = nullptr, size_t maxResults = 0,
+			uint8_t coarsePoints = 12, uint8_t finePoints = 8) {
+		if (speedPercent < 1 || speedPercent > 100 || coarsePoints < 2) {
+			return 0;
+		}
+		setSpeedA(speedPercent);
+		setSpeedB(speedPercent);
+		while (ramping()) {
+			tick();
+		}
+
+		const uint16_t previousHz = _frequencyHz;
+		FrequencySample best = {0, 0.0f, 0.0f};
+		uint8_t bestIndex = 0;
+		size_t written = 0;
+		for (uint8_t i = 0; i < coarsePoints; i++) {
+			FrequencySample sample;
+			if (!measureFrequency(sweepPoint(MIN_FREQUENCY, MAX_FREQUENCY, i, coarsePoints, true), sample)) {
+				continue;
+			}
+			if (results != nullptr && written < maxResults) {
+				results[written++] = sample;
+			}
+			if (best.frequencyHz == 0 || sample.meanMa < best.meanMa) {
+				best = sample;
+				bestIndex = i;
+			}
+		}
+		if (best.frequencyHz == 0) {
+			// leave the PWM where it was before the sweep
+			setFrequency(previousHz);
+			return 0;
+		}
+
+		const uint16_t fineFrom = sweepPoint(MIN_FREQUENCY, MAX_FREQUENCY, bestIndex > 0 ? bestIndex - 1 : 0, coarsePoints, true);
+		const uint16_t fineTo = sweepPoint(MIN_FREQUENCY, MAX_FREQUENCY, bestIndex + 1 < coarsePoints ? bestIndex + 1 : bestIndex, coarsePoints, true);
+		for (uint8_t i = 0; i < finePoints; i++) {
+			FrequencySample sample;
+			if (!measureFrequency(sweepPoint(fineFrom, fineTo, i, finePoints, false), sample)) {
+				continue;
+			}
+			if (results != nullptr && written < maxResults) {
+				results[written++] = sample;
+			}
+			if (sample.meanMa < best.meanMa) {
+				best = sample;
+			}
+		}
+
+		setFrequency(best.frequencyHz);
+		return best.frequencyHz;
+	}
+
 	/**
 	 * @brief Configure half-full-scale current sense mode.
 	 * This affects the scaling of sensed current telemetry.
@@ -398,6 +767,8 @@ public:
 		_hfsEnabled = (flags & FLAG_HFS) != 0;
 		_decayMode = (flags & FLAG_DECAY_MASK) >> FLAG_DECAY_SHIFT;
 		_releaseOnCompleteReported = (flags & FLAG_RELEASE) != 0;
+		settleMove();
+		integrateEnergy();
 		return true;
 	}
 
@@ -433,6 +804,58 @@ public:
 		return senseRawToMa(_senseRawB, _hfsEnabled);
 	}
 
+	/**
+	 * @brief Set the supply voltage used to turn accumulated charge into energy.
+	 * @param volts Motor supply voltage in volts.
+	 */
+	void setSupplyVoltage(float volts) {
+		_supplyVolts = volts;
+	}
+
+	/**
+	 * @brief Get the supply voltage used for energy estimates.
+	 * @return Motor supply voltage in volts.
+	 */
+	float supplyVoltage() const {
+		return _supplyVolts;
+	}
+
+	/**
+	 * @brief Get charge and energy accumulated since construction or resetEnergy().
+	 * Current is integrated with the trapezoidal rule on every update() call,
+	 * so accuracy depends on how often telemetry is polled.
+	 * @return Accumulated totals.
+	 */
+	EnergyReport energyTotal() const {
+		return energyReport(_energyTotal);
+	}
+
+	/**
+	 * @brief Get charge and energy accumulated since the last move or speed command.
+	 * @return Totals of the running segment.
+	 */
+	EnergyReport energySegment() const {
+		return energyReport(_energySegment);
+	}
+
+	/**
+	 * @brief Get charge and energy of the segment that ended with the last move or speed command.
+	 * Commands sent without an update() in between are merged into one segment.
+	 * @return Totals of the previous segment.
+	 */
+	EnergyReport energyLastSegment() const {
+		return energyReport(_energyLastSegment);
+	}
+
+	/**
+	 * @brief Clear all charge and energy totals.
+	 */
+	void resetEnergy() {
+		_energyTotal = EnergyCounter();
+		_energySegment = EnergyCounter();
+		_energyLastSegment = EnergyCounter();
+	}
+
 	/**
 	 * @brief Get busy flag from last telemetry update.
 	 * @return True while module reports active move.
@@ -527,6 +950,8 @@ private:
 	static constexpr uint8_t CMD_FREQ_DC = static_cast<uint8_t>('F');
 	static constexpr uint8_t CMD_HFS = static_cast<uint8_t>('X');
 
+	static constexpr uint8_t FREQUENCY_SAMPLE_INTERVAL_MS = 5;
+
 	static constexpr uint8_t FLAG_BUSY = 0x01;
 	static constexpr uint8_t FLAG_MODE = 0x02;
 	static constexpr uint8_t FLAG_STEP_MODE = 0x04;
@@ -563,7 +988,176 @@ private:
 		if (_invertB) {
 			rawB = static_cast<int16_t>(-rawB);
 		}
-		return setDcSpeedRaw(rawA, rawB);
+		return rampDcSpeedRaw(rawA, rawB);
+	}
+
+	/**
+	 * @brief Write raw DC speeds to the module and remember them.
+	 * @return True on successful command write.
+	 */
+	bool sendDcSpeed(int16_t speedA, int16_t speedB) {
+		uint8_t cmd[5];
+		cmd[0] = CMD_SPEED_DC;
+		cmd[1] = static_cast<uint8_t>(speedA & 0xFF);
+		cmd[2] = static_cast<uint8_t>((speedA >> 8) & 0xFF);
+		cmd[3] = static_cast<uint8_t>(speedB & 0xFF);
+		cmd[4] = static_cast<uint8_t>((speedB >> 8) & 0xFF);
+		const bool ok = sendCommand(cmd, sizeof(cmd));
+		if (ok) {
+			_sentRawA = speedA;
+			_sentRawB = speedB;
+		}
+		return ok;
+	}
+
+	/**
+	 * @brief Get the frequency of point @p index out of @p points spanning @p fromHz..@p toHz.
+	 */
+	static uint16_t sweepPoint(uint16_t fromHz, uint16_t toHz, uint8_t index, uint8_t points, bool logarithmic) {
+		if (points < 2) {
+			return fromHz;
+		}
+		const float t = static_cast<float>(index) / static_cast<float>(points - 1);
+		float f;
+		if (logarithmic) {
+			f = fromHz * powf(static_cast<float>(toHz) / fromHz, t);
+		} else {
+			f = fromHz + (static_cast<float>(toHz) - fromHz) * t;
+		}
+		if (index == 0) {
+			return fromHz;
+		}
+		if (index >= points - 1) {
+			return toHz;
+		}
+		return static_cast<uint16_t>(f + 0.5f);
+	}
+
+	/**
+	 * @brief Estimate how many steps of the current move have been executed.
+	 * The first step is executed immediately, the rest are paced by the step period.
+	 */
+	uint32_t movedSteps() const {
+		if (!_moveActive) {
+			return 0;
+		}
+		const uint32_t elapsedTicks = (micros() - _moveStartUs) / 100UL;
+		const uint32_t done = 1 + elapsedTicks / _movePeriod;
+		return done < _moveSteps ? done : _moveSteps;
+	}
+
+	int32_t movedUnits() const {
+		return static_cast<int32_t>(movedSteps()) * _moveUnits;
+	}
+
+	/**
+	 * @brief Fold the current move into the absolute position once it has ended,
+	 * before micros() can wrap around its start time.
+	 */
+	void settleMove() {
+		if (_moveActive && movedSteps() >= _moveSteps) {
+			abortMove();
+		}
+	}
+
+	/**
+	 * @brief Fold the progress of the current move into the absolute position.
+	 */
+	void abortMove() {
+		_positionUnits += movedUnits();
+		_moveActive = false;
+	}
+
+	/**
+	 * @brief Move a ramp value towards its target by at most @p maxDelta.
+	 */
+	static int16_t rampStep(int16_t current, int16_t target, uint32_t maxDelta) {
+		const int32_t diff = static_cast<int32_t>(target) - current;
+		if (diff > 0) {
+			return static_cast<uint32_t>(diff) <= maxDelta ? target : static_cast<int16_t>(current + static_cast<int32_t>(maxDelta));
+		}
+		if (diff < 0) {
+			return static_cast<uint32_t>(-diff) <= maxDelta ? target : static_cast<int16_t>(current - static_cast<int32_t>(maxDelta));
+		}
+		return current;
+	}
+
+	/**
+	 * @brief Round a ramp value to RAMP_RESOLUTION, passing the final target through unchanged.
+	 */
+	static int16_t rampQuantize(int16_t value, int16_t target) {
+		if (value == target) {
+			return value;
+		}
+		const int32_t q = ((value < 0 ? value - RAMP_RESOLUTION / 2 : value + RAMP_RESOLUTION / 2) / RAMP_RESOLUTION) * RAMP_RESOLUTION;
+		return static_cast<int16_t>(q);
+	}
+
+	/**
+	 * @brief Charge integral kept in integer units so a telemetry poll costs a few additions.
+	 * Units are half-scale raw counts times microseconds, doubled by the trapezoidal rule.
+	 */
+	struct EnergyCounter {
+		uint64_t rawUsA = 0;
+		uint64_t rawUsB = 0;
+		uint64_t durationUs = 0;
+		uint16_t samples = 0;
+	};
+
+	/**
+	 * @brief Add the interval since the previous poll to the running totals.
+	 */
+	void integrateEnergy() {
+		const uint32_t now = micros();
+		// half-scale counts: one full-scale count carries twice the current
+		const uint32_t a = static_cast<uint32_t>(_senseRawA) * (_hfsEnabled ? 1 : 2);
+		const uint32_t b = static_cast<uint32_t>(_senseRawB) * (_hfsEnabled ? 1 : 2);
+		if (_energyPrimed) {
+			const uint32_t dt = now - _energyLastUs;
+			const uint64_t dA = static_cast<uint64_t>(a + _energyLastA) * dt;
+			const uint64_t dB = static_cast<uint64_t>(b + _energyLastB) * dt;
+			_energyTotal.rawUsA += dA;
+			_energyTotal.rawUsB += dB;
+			_energyTotal.durationUs += dt;
+			_energySegment.rawUsA += dA;
+			_energySegment.rawUsB += dB;
+			_energySegment.durationUs += dt;
+			if (_energySegment.samples < 0xFFFF) {
+				_energySegment.samples++;
+			}
+		}
+		_energyPrimed = true;
+		_energyLastUs = now;
+		_energyLastA = static_cast<uint16_t>(a);
+		_energyLastB = static_cast<uint16_t>(b);
+	}
+
+	/**
+	 * @brief Close the running energy segment and start a new one.
+	 */
+	void beginEnergySegment() {
+		if (_energySegment.samples == 0) {
+			return;
+		}
+		_energyLastSegment = _energySegment;
+		_energySegment = EnergyCounter();
+	}
+
+	/**
+	 * @brief Convert an integer charge integral to physical units.
+	 */
+	EnergyReport energyReport(const EnergyCounter& counter) const {
+		// mA per half-scale count, and 2 * 3.6e9 us*mA per mAh (trapezoid doubling included)
+		const float maPerCount = senseRawToMa(1, true);
+		const float toMah = maPerCount / 7.2e9f;
+		EnergyReport report;
+		report.chargeMahA = static_cast<float>(counter.rawUsA) * toMah;
+		report.chargeMahB = static_cast<float>(counter.rawUsB) * toMah;
+		// 1 mAh at 1 V is 3.6 J
+		report.energyJA = report.chargeMahA * _supplyVolts * 3.6f;
+		report.energyJB = report.chargeMahB * _supplyVolts * 3.6f;
+		report.durationMs = static_cast<uint32_t>(counter.durationUs / 1000UL);
+		return report;
 	}
 
 	/**
@@ -595,6 +1189,31 @@ private:
 	bool _releaseOnCompleteReported = false;
 	bool _busy = false;
 
+	int16_t _sentRawA = 0;
+	int16_t _sentRawB = 0;
+	int16_t _rampCurrentA = 0;
+	int16_t _rampCurrentB = 0;
+	int16_t _rampTargetA = 0;
+	int16_t _rampTargetB = 0;
+	uint32_t _accelRawPerSec = 0;
+	uint32_t _rampLastUs = 0;
+
+	int32_t _positionUnits = 0;
+	bool _moveActive = false;
+	int8_t _moveUnits = 0;
+	uint16_t _movePeriod = 1;
+	uint32_t _moveSteps = 0;
+	uint32_t _moveStartUs = 0;
+
+	float _supplyVolts = 12.0f;
+	EnergyCounter _energyTotal;
+	EnergyCounter _energySegment;
+	EnergyCounter _energyLastSegment;
+	bool _energyPrimed = false;
+	uint32_t _energyLastUs = 0;
+	uint16_t _energyLastA = 0;
+	uint16_t _energyLastB = 0;
+
 	uint16_t _senseRawA = 0;
 	uint16_t _senseRawB = 0;
 	int16_t _stepsPerRevolution = -1;
@@ -0,0 +1,337 @@
+#pragma once
+
+#include "ModulinoMotors.h"
+
+/**
+ * @brief Coordinates stepper moves across several Modulino Motors boards.
+ * Each board drives one axis in stepper mode. Straight-line moves are split into
+ * short segments whose per-axis step counts follow a Bresenham line, and every
+ * axis gets a step period chosen so that all axes finish a segment together.
+ * Segments are streamed from a small fixed queue by calling poll() from loop().
+ */
+class ModulinoMotorsGroup {
+public:
+	static constexpr uint8_t MAX_AXES = 4;
+	static constexpr uint8_t QUEUE_LENGTH = 8;
+	static constexpr uint16_t DEFAULT_MIN_PERIOD = 20;
+	static constexpr uint16_t DEFAULT_SEGMENT_STEPS = 32;
+
+	/**
+	 * @brief Add a motors board as the next axis of the group.
+	 * The board must already be initialized and switched to stepper mode.
+	 * @param motors Motors board driving this axis.
+	 * @return True when the axis was added.
+	 */
+	bool addAxis(ModulinoMotors& motors) {
+		if (_axes >= MAX_AXES || !idle()) {
+			return false;
+		}
+		_motors[_axes] = &motors;
+		_position[_axes] = 0;
+		_lineStart[_axes] = 0;
+		_periodError[_axes] = 0;
+		_axes++;
+		return true;
+	}
+
+	/**
+	 * @brief Get the number of axes in the group.
+	 * @return Axis count.
+	 */
+	uint8_t axes() const {
+		return _axes;
+	}
+
+	/**
+	 * @brief Set the step period used by the dominant axis of a line.
+	 * @param periodTicks Step period in 0.1 ms timer ticks (1..65535).
+	 * @return True when accepted.
+	 */
+	bool setMinPeriod(uint16_t periodTicks) {
+		if (periodTicks < 1) {
+			return false;
+		}
+		_minPeriod = periodTicks;
+		return true;
+	}
+
+	/**
+	 * @brief Get the step period used by the dominant axis of a line.
+	 * @return Step period in 0.1 ms timer ticks.
+	 */
+	uint16_t minPeriod() const {
+		return _minPeriod;
+	}
+
+	/**
+	 * @brief Set the maximum number of dominant-axis steps sent in one segment.
+	 * Shorter segments follow curves and shallow lines more closely, longer
+	 * segments need fewer bus transactions.
+	 * @param steps Dominant-axis steps per segment, must be >= 1.
+	 * @return True when accepted.
+	 */
+	bool setSegmentSteps(uint16_t steps) {
+		if (steps < 1) {
+			return false;
+		}
+		_segmentSteps = steps;
+		return true;
+	}
+
+	/**
+	 * @brief Get the maximum number of dominant-axis steps sent in one segment.
+	 * @return Dominant-axis steps per segment.
+	 */
+	uint16_t segmentSteps() const {
+		return _segmentSteps;
+	}
+
+	/**
+	 * @brief Queue a straight-line move to an absolute position.
+	 * @param target Target position in steps, one entry per axis.
+	 * @param periodTicks Dominant-axis step period in 0.1 ms ticks, 0 for minPeriod().
+	 * @return True when the move was queued, false if the queue is full.
+	 */
+	bool moveTo(const int32_t* target, uint16_t periodTicks = 0) {
+		if (_axes == 0 || _count >= QUEUE_LENGTH) {
+			return false;
+		}
+		Line& line = _queue[(_head + _count) % QUEUE_LENGTH];
+		for (uint8_t i = 0; i < _axes; i++) {
+			line.target[i] = target[i];
+		}
+		line.period = periodTicks != 0 ? periodTicks : _minPeriod;
+		_count++;
+		if (_count == 1 && !_segmentActive) {
+			beginLine();
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Queue a straight-line move relative to the end of the last queued move.
+	 * @param steps Signed step count, one entry per axis.
+	 * @param periodTicks Dominant-axis step period in 0.1 ms ticks, 0 for minPeriod().
+	 * @return True when the move was queued, false if the queue is full.
+	 */
+	bool moveBy(const int32_t* steps, uint16_t periodTicks = 0) {
+		int32_t target[MAX_AXES];
+		for (uint8_t i = 0; i < _axes; i++) {
+			target[i] = queuedEnd(i) + steps[i];
+		}
+		return moveTo(target, periodTicks);
+	}
+
+	/**
+	 * @brief Stream the next segment once the running one has finished.
+	 * Call this as often as possible from loop(); late calls leave a gap between segments.
+	 * @return True while motion is still pending.
+	 */
+	bool poll() {
+		if (_segmentActive) {
+			if ((uint32_t)(micros() - _segmentStartUs) / 100UL < _segmentTicks) {
+				return true;
+			}
+			_segmentActive = false;
+		}
+		while (_count > 0) {
+			if (startSegment()) {
+				return true;
+			}
+			// line finished, move on to the next queued one
+			_head = (_head + 1) % QUEUE_LENGTH;
+			_count--;
+			if (_count > 0) {
+				beginLine();
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Check whether all queued moves have been sent and completed.
+	 * @return True when the group is idle.
+	 */
+	bool idle() const {
+		return _count == 0 && !_segmentActive;
+	}
+
+	/**
+	 * @brief Get the number of free slots in the move queue.
+	 * @return Free queue entries.
+	 */
+	uint8_t queueAvailable() const {
+		return QUEUE_LENGTH - _count;
+	}
+
+	/**
+	 * @brief Flush the queue and hold every axis at its current step.
+	 * Steps of an interrupted segment are not accounted for in position().
+	 */
+	void stop() {
+		_count = 0;
+		_head = 0;
+		_segmentActive = false;
+		for (uint8_t i = 0; i < _axes; i++) {
+			_motors[i]->hold();
+		}
+	}
+
+	/**
+	 * @brief Get the commanded position of an axis.
+	 * Includes all segments sent so far, including the one currently running.
+	 * @param axis Axis index in order of addAxis() calls.
+	 * @return Position in steps.
+	 */
+	int32_t position(uint8_t axis) const {
+		return axis < _axes ? _position[axis] : 0;
+	}
+
+	/**
+	 * @brief Redefine the current position of all axes without moving.
+	 * @param position New position in steps, one entry per axis.
+	 * @return True when accepted, false while moves are pending.
+	 */
+	bool setPosition(const int32_t* position) {
+		if (!idle()) {
+			return false;
+		}
+		for (uint8_t i = 0; i < _axes; i++) {
+			_position[i] = position[i];
+		}
+		return true;
+	}
+
+private:
+	struct Line {
+		int32_t target[MAX_AXES];
+		uint16_t period;
+	};
+
+	/**
+	 * @brief Latch the start point and dominant axis of the line at the queue head.
+	 */
+	void beginLine() {
+		const Line& line = _queue[_head];
+		_lineLength = 0;
+		for (uint8_t i = 0; i < _axes; i++) {
+			_lineStart[i] = _position[i];
+			const uint32_t d = magnitude(line.target[i] - _position[i]);
+			if (d > _lineLength) {
+				_lineLength = d;
+			}
+		}
+		_lineDone = 0;
+	}
+
+	/**
+	 * @brief Send the next segment of the current line to all axes.
+	 * @return False when the line has no steps left.
+	 */
+	bool startSegment() {
+		const Line& line = _queue[_head];
+		if (_lineDone >= _lineLength) {
+			return false;
+		}
+
+		uint32_t next = _lineDone + _segmentSteps;
+		if (next > _lineLength) {
+			next = _lineLength;
+		}
+		const uint32_t dominant = next - _lineDone;
+		const uint32_t duration = dominant * line.period;
+
+		// Compute every command first so the writes go out back to back.
+		int32_t steps[MAX_AXES];
+		uint16_t period[MAX_AXES];
+		for (uint8_t i = 0; i < _axes; i++) {
+			const int32_t delta = line.target[i] - _lineStart[i];
+			const int32_t end = _lineStart[i] + scale(delta, next, _lineLength);
+			steps[i] = end - _position[i];
+			period[i] = axisPeriod(i, magnitude(steps[i]), duration);
+		}
+		for (uint8_t i = 0; i < _axes; i++) {
+			if (steps[i] != 0) {
+				_motors[i]->moveStepper(steps[i], period[i]);
+			}
+		}
+		_segmentStartUs = micros();
+		_segmentTicks = duration;
+		_segmentActive = true;
+
+		for (uint8_t i = 0; i < _axes; i++) {
+			_position[i] += steps[i];
+		}
+		_lineDone = next;
+		return true;
+	}
+
+	/**
+	 * @brief Pick the step period that spreads a step count over a segment duration.
+	 * The truncated remainder is carried into the next segment of the same axis,
+	 * so quantization to whole ticks never accumulates into drift between axes.
+	 * @param axis Axis index.
+	 * @param steps Unsigned step count of the segment.
+	 * @param duration Segment duration in 0.1 ms ticks.
+	 * @return Step period in 0.1 ms ticks.
+	 */
+	uint16_t axisPeriod(uint8_t axis, uint32_t steps, uint32_t duration) {
+		if (steps == 0) {
+			return 1;
+		}
+		const uint32_t budget = duration + _periodError[axis];
+		uint32_t period = budget / steps;
+		if (period < 1) {
+			period = 1;
+		} else if (period > 65535) {
+			period = 65535;
+		}
+		const uint32_t used = period * steps;
+		_periodError[axis] = used < budget ? budget - used : 0;
+		return static_cast<uint16_t>(period);
+	}
+
+	/**
+	 * @brief Get the position an axis will reach once all queued moves are done.
+	 * @param axis Axis index.
+	 * @return Position in steps.
+	 */
+	int32_t queuedEnd(uint8_t axis) const {
+		if (_count == 0) {
+			return _position[axis];
+		}
+		return _queue[(_head + _count - 1) % QUEUE_LENGTH].target[axis];
+	}
+
+	/**
+	 * @brief Integer Bresenham interpolation of @p delta at @p num / @p den, rounded to nearest.
+	 */
+	static int32_t scale(int32_t delta, uint32_t num, uint32_t den) {
+		const int64_t scaled = static_cast<int64_t>(magnitude(delta)) * num;
+		const int32_t rounded = static_cast<int32_t>((scaled + den / 2) / den);
+		return delta < 0 ? -rounded : rounded;
+	}
+
+	static uint32_t magnitude(int32_t value) {
+		return value < 0 ? static_cast<uint32_t>(-static_cast<int64_t>(value)) : static_cast<uint32_t>(value);
+	}
+
+	ModulinoMotors* _motors[MAX_AXES] = {nullptr};
+	uint8_t _axes = 0;
+	uint16_t _minPeriod = DEFAULT_MIN_PERIOD;
+	uint16_t _segmentSteps = DEFAULT_SEGMENT_STEPS;
+
+	Line _queue[QUEUE_LENGTH];
+	uint8_t _head = 0;
+	uint8_t _count = 0;
+
+	int32_t _position[MAX_AXES] = {0};
+	int32_t _lineStart[MAX_AXES] = {0};
+	uint32_t _periodError[MAX_AXES] = {0};
+	uint32_t _lineLength = 0;
+	uint32_t _lineDone = 0;
+
+	bool _segmentActive = false;
+	uint32_t _segmentStartUs = 0;
+	uint32_t _segmentTicks = 0;
+};